@@ -0,0 +1,228 @@
+/**
+ * @file csv.h
+ * @brief Schema-driven CSV parsing shared by the NMS table loaders.
+ *
+ * @details
+ * Files are read in one piece and split into std::string_view lines that point into that
+ * buffer, so nothing is copied until a field lands in its column. A table's schema is the
+ * list of columns handed to csv_Parse: field k of every row is converted to the element
+ * type of the k-th column (std::string, double, int or bool).
+ *
+ * Numbers go through std::from_chars and no exceptions are thrown. A row with too few
+ * fields is skipped, a field that does not convert is stored as 0/false; both are
+ * reported as a CsvError with the file and line they came from. Lines flagged dead are
+ * placeholders for deleted rows: they keep their position as a default row.
+ */
+
+#ifndef NMS_CSV_H
+#define NMS_CSV_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One line of table data and where it was read from
+struct CsvLine
+{
+    std::string_view text;
+    int source = 0;     // Index into CsvData::files
+    long long line = 0; // 1-based line number in that file
+    bool dead = false;  // Tombstone of a deleted row, text is empty
+};
+
+// Rows of a table together with the buffers they point into
+struct CsvData
+{
+    std::deque<std::string> buffers; // Whole files as read, a deque so the views stay valid
+    std::vector<std::string> files;  // File name of each buffer
+    std::string_view header;         // Table header (may point into any buffer)
+    std::vector<CsvLine> rows;
+};
+
+struct CsvError
+{
+    std::string file;
+    long long line;
+    std::string message;
+    std::string text; // Raw lines of the rows the problem dropped, empty when none was
+};
+
+// Reads a whole file into out, returns false when it cannot be opened
+inline bool csv_ReadFile(const std::string &path, std::string &out)
+{
+    out.clear();
+    FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+    if (std::fseek(f, 0, SEEK_END) == 0)
+    {
+        long size = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        if (size > 0)
+        {
+            out.resize((size_t)size);
+            out.resize(std::fread(&out[0], 1, (size_t)size, f));
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+// Reads a file into data and returns its index for CsvLine::source, -1 when it cannot be opened
+inline int csv_AddFile(CsvData &data, const std::string &path)
+{
+    std::string buf;
+    if (!csv_ReadFile(path, buf))
+        return -1;
+    data.buffers.push_back(std::move(buf));
+    data.files.push_back(path);
+    return (int)data.files.size() - 1;
+}
+
+// Takes the next line off rest without its line ending, returns false at the end
+inline bool csv_NextLine(std::string_view &rest, std::string_view &line)
+{
+    if (rest.empty())
+        return false;
+    const char *nl = (const char *)std::memchr(rest.data(), '\n', rest.size());
+    size_t len = nl ? (size_t)(nl - rest.data()) : rest.size();
+    line = rest.substr(0, len);
+    rest.remove_prefix(nl ? len + 1 : len);
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    return true;
+}
+
+// Splits a line into n fields. The last field keeps any further commas, as the old loaders did.
+inline bool csv_Split(std::string_view line, std::string_view *fields, size_t n)
+{
+    for (size_t k = 0; k + 1 < n; k++)
+    {
+        const char *c = (const char *)std::memchr(line.data(), ',', line.size());
+        if (!c)
+            return false;
+        size_t len = (size_t)(c - line.data());
+        fields[k] = line.substr(0, len);
+        line.remove_prefix(len + 1);
+    }
+    fields[n - 1] = line;
+    return true;
+}
+
+inline std::string_view csv_Trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+        s.remove_suffix(1);
+    if (s.size() > 1 && s.front() == '+')
+        s.remove_prefix(1);
+    return s;
+}
+
+// Field conversions, false when the text is not a valid value of the type
+inline bool csv_Field(std::string_view f, std::string &out)
+{
+    out.assign(f.data(), f.size());
+    return true;
+}
+inline bool csv_Field(std::string_view f, double &out)
+{
+    f = csv_Trim(f);
+    out = 0.0;
+    auto r = std::from_chars(f.data(), f.data() + f.size(), out);
+    if (r.ec != std::errc() || r.ptr != f.data() + f.size())
+    {
+        out = 0.0;
+        return false;
+    }
+    return true;
+}
+inline bool csv_Field(std::string_view f, int &out)
+{
+    f = csv_Trim(f);
+    out = 0;
+    auto r = std::from_chars(f.data(), f.data() + f.size(), out);
+    if (r.ec != std::errc() || r.ptr != f.data() + f.size())
+    {
+        out = 0;
+        return false;
+    }
+    return true;
+}
+inline bool csv_Field(std::string_view f, std::uint64_t &out)
+{
+    f = csv_Trim(f);
+    out = 0;
+    auto r = std::from_chars(f.data(), f.data() + f.size(), out);
+    if (r.ec != std::errc() || r.ptr != f.data() + f.size())
+    {
+        out = 0;
+        return false;
+    }
+    return true;
+}
+inline bool csv_Field(std::string_view f, bool &out)
+{
+    f = csv_Trim(f);
+    out = (f == "1");
+    return f == "1" || f == "0";
+}
+// Any other string-like cell that can be assigned from a view (e.g. an arena-backed string)
+template <class T>
+bool csv_Field(std::string_view f, T &&out)
+{
+    out = f;
+    return true;
+}
+
+// Parses the rows of data into the given columns (arrays, vectors or table columns already
+// sized for them), at most maxRows rows. Returns the number of rows stored; problems are
+// appended to errors and the rows stored for dead lines to dead. An error that drops rows
+// carries their raw lines.
+template <class... Cols>
+int csv_Parse(const CsvData &data, int maxRows, std::vector<CsvError> &errors, std::vector<int> &dead, Cols &...cols)
+{
+    const size_t n = sizeof...(Cols);
+    std::string_view fields[n];
+    int count = 0;
+    for (const CsvLine &l : data.rows)
+    {
+        if (count >= maxRows)
+        {
+            CsvError e{data.files[l.source], l.line, "table is full; remaining rows ignored"};
+            for (size_t i = &l - data.rows.data(); i < data.rows.size(); i++)
+                if (!data.rows[i].dead)
+                    e.text += std::string(data.rows[i].text) + "\n";
+            errors.push_back(e);
+            break;
+        }
+        if (l.dead)
+        {
+            dead.push_back(count++);
+            continue;
+        }
+        if (!csv_Split(l.text, fields, n))
+        {
+            errors.push_back({data.files[l.source], l.line, "expected " + std::to_string(n) + " fields", std::string(l.text) + "\n"});
+            continue;
+        }
+        size_t column = 0;
+        auto field = [&](auto &col)
+        {
+            if (!csv_Field(fields[column], col[count]))
+                errors.push_back({data.files[l.source], l.line, "bad value in field " + std::to_string(column + 1)});
+            column++;
+        };
+        (field(cols), ...);
+        count++;
+    }
+    return count;
+}
+
+#endif
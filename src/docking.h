@@ -0,0 +1,327 @@
+/**
+ * @file docking.h
+ * @brief Clohessy-Wiltshire relative motion on a fixed time step, and an approach planner.
+ *
+ * @details
+ * The chaser is tracked in the target's orbital frame: x points away from the Earth
+ * (radial), y along the direction of flight, the target sits at the origin. For a target on
+ * a circular orbit of mean motion n the in-plane motion is
+ *
+ *     x'' = 3 n^2 x + 2 n y'        y'' = -2 n x'
+ *
+ * Thrust is applied as impulses (changes of velocity between steps), so between burns the
+ * system is linear and time invariant. One classic RK4 step of length dt is therefore a fixed
+ * 4x4 matrix; dock_Model builds it once by stepping the unit states, and every later step is
+ * a matrix-vector product. Stepping allocates nothing and has no branches.
+ *
+ * The planner (dock_Plan) searches two-burn approaches: coast, burn onto a transfer that
+ * reaches the target after a given time, coast, burn to stop. Every pair of coast and
+ * transfer times on a grid is one candidate trajectory. The candidates are flown together
+ * through the integrator in structure-of-arrays lanes (DockLanes), a tile of lanes at a time
+ * so a tile stays in cache, and the one with the least total velocity change that ends on
+ * the target wins. A lane that has run its own number of steps keeps its state by a select,
+ * so the lane loop has no branches. Lanes are stepped four at a time with AVX2 where the CPU
+ * has it (chosen at run time as in rollup.h); the vector path multiplies and adds in the same
+ * order as the scalar one, so a trajectory ends in the same state on either path and when
+ * flown alone with dock_Step.
+ */
+
+#ifndef NMS_DOCKING_H
+#define NMS_DOCKING_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "rollup.h"
+
+const double DOCK_MEAN_MOTION = 0.00113; // rad/s, a low Earth orbit of about 93 minutes
+const double DOCK_DT = 0.5;              // Seconds of flight per step
+const double DOCK_MISS = 0.05;           // Metres from the target an approach may end
+const int DOCK_TILE = 64;                // Lanes flown together, 2 KiB of state
+
+struct DockState
+{
+    double x = 0, y = 0;   // Radial and along-track offset, m
+    double vx = 0, vy = 0; // m/s
+};
+
+// One step of the integrator as a matrix on (x, y, vx, vy)
+struct DockModel
+{
+    double n = DOCK_MEAN_MOTION;
+    double dt = DOCK_DT;
+    double phi[4][4] = {};
+};
+
+// Trajectories in structure-of-arrays form, lane i runs steps[i] steps
+struct DockLanes
+{
+    std::vector<double> x, y, vx, vy;
+    std::vector<int> steps;
+    std::vector<double> dv; // First burn of each lane, x and y
+};
+
+// An approach found by dock_Plan, times in steps from the state it was planned from
+struct DockPlan
+{
+    bool found = false;
+    int coast = 0, transfer = 0;
+    double dv1x = 0, dv1y = 0; // Burn onto the transfer
+    double dv2x = 0, dv2y = 0; // Burn to stop at the target
+    double fuel = 0;           // |dv1| + |dv2|, m/s
+    double miss = 0;           // Distance from the target before the last burn, m
+    long long evaluated = 0;   // Candidate trajectories flown
+    long long steps = 0;       // Lane steps taken
+    double ms = 0;
+};
+
+inline void dock_Deriv(double n, const double s[4], double d[4])
+{
+    d[0] = s[2];
+    d[1] = s[3];
+    d[2] = 3 * n * n * s[0] + 2 * n * s[3];
+    d[3] = -2 * n * s[2];
+}
+
+// One RK4 step of the unforced equations, used once per unit state by dock_Model
+inline void dock_Rk4(double n, double dt, double s[4])
+{
+    double k1[4], k2[4], k3[4], k4[4], t[4];
+    dock_Deriv(n, s, k1);
+    for (int i = 0; i < 4; i++)
+        t[i] = s[i] + dt / 2 * k1[i];
+    dock_Deriv(n, t, k2);
+    for (int i = 0; i < 4; i++)
+        t[i] = s[i] + dt / 2 * k2[i];
+    dock_Deriv(n, t, k3);
+    for (int i = 0; i < 4; i++)
+        t[i] = s[i] + dt * k3[i];
+    dock_Deriv(n, t, k4);
+    for (int i = 0; i < 4; i++)
+        s[i] += dt / 6 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+}
+
+inline DockModel dock_Model(double n = DOCK_MEAN_MOTION, double dt = DOCK_DT)
+{
+    DockModel m;
+    m.n = n;
+    m.dt = dt;
+    for (int j = 0; j < 4; j++)
+    {
+        double e[4] = {0, 0, 0, 0};
+        e[j] = 1;
+        dock_Rk4(n, dt, e);
+        for (int i = 0; i < 4; i++)
+            m.phi[i][j] = e[i];
+    }
+    return m;
+}
+
+inline void dock_Step(const DockModel &m, DockState &s)
+{
+    const double(*p)[4] = m.phi;
+    double x = s.x, y = s.y, vx = s.vx, vy = s.vy;
+    s.x = p[0][0] * x + p[0][1] * y + p[0][2] * vx + p[0][3] * vy;
+    s.y = p[1][0] * x + p[1][1] * y + p[1][2] * vx + p[1][3] * vy;
+    s.vx = p[2][0] * x + p[2][1] * y + p[2][2] * vx + p[2][3] * vy;
+    s.vy = p[3][0] * x + p[3][1] * y + p[3][2] * vx + p[3][3] * vy;
+}
+
+// Step k of lanes [0, n): lanes with fewer than k + 1 steps to run keep their state
+inline void dock_StepLanes(const DockModel &m, double *x, double *y, double *vx, double *vy, const int *steps, int k, int n)
+{
+    const double(*p)[4] = m.phi;
+    for (int i = 0; i < n; i++)
+    {
+        double a = x[i], b = y[i], c = vx[i], d = vy[i];
+        double na = p[0][0] * a + p[0][1] * b + p[0][2] * c + p[0][3] * d;
+        double nb = p[1][0] * a + p[1][1] * b + p[1][2] * c + p[1][3] * d;
+        double nc = p[2][0] * a + p[2][1] * b + p[2][2] * c + p[2][3] * d;
+        double nd = p[3][0] * a + p[3][1] * b + p[3][2] * c + p[3][3] * d;
+        bool on = k < steps[i];
+        x[i] = on ? na : a;
+        y[i] = on ? nb : b;
+        vx[i] = on ? nc : c;
+        vy[i] = on ? nd : d;
+    }
+}
+
+#ifdef ROLLUP_X86
+ROLLUP_AVX2 inline __m256d dock_Row(const __m256d *p, __m256d a, __m256d b, __m256d c, __m256d d)
+{
+    __m256d r = _mm256_add_pd(_mm256_mul_pd(p[0], a), _mm256_mul_pd(p[1], b));
+    r = _mm256_add_pd(r, _mm256_mul_pd(p[2], c));
+    return _mm256_add_pd(r, _mm256_mul_pd(p[3], d));
+}
+
+ROLLUP_AVX2 inline void dock_StepLanesAvx2(const DockModel &m, double *x, double *y, double *vx, double *vy, const int *steps, int k, int n)
+{
+    __m256d p[4][4];
+    for (int r = 0; r < 4; r++)
+        for (int c = 0; c < 4; c++)
+            p[r][c] = _mm256_set1_pd(m.phi[r][c]);
+    __m128i kk = _mm_set1_epi32(k);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d a = _mm256_loadu_pd(x + i), b = _mm256_loadu_pd(y + i);
+        __m256d c = _mm256_loadu_pd(vx + i), d = _mm256_loadu_pd(vy + i);
+        __m256d on = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(steps + i)), kk)));
+        _mm256_storeu_pd(x + i, _mm256_blendv_pd(a, dock_Row(p[0], a, b, c, d), on));
+        _mm256_storeu_pd(y + i, _mm256_blendv_pd(b, dock_Row(p[1], a, b, c, d), on));
+        _mm256_storeu_pd(vx + i, _mm256_blendv_pd(c, dock_Row(p[2], a, b, c, d), on));
+        _mm256_storeu_pd(vy + i, _mm256_blendv_pd(d, dock_Row(p[3], a, b, c, d), on));
+    }
+    dock_StepLanes(m, x + i, y + i, vx + i, vy + i, steps + i, k, n - i);
+}
+#endif
+
+// Runs every lane its own number of steps, returns the lane steps taken
+inline long long dock_Fly(const DockModel &m, DockLanes &l, bool simd = rollup_HasAvx2())
+{
+    int n = (int)l.steps.size();
+    long long taken = 0;
+    for (int t = 0; t < n; t += DOCK_TILE)
+    {
+        int w = std::min(DOCK_TILE, n - t);
+        int longest = *std::max_element(l.steps.begin() + t, l.steps.begin() + t + w);
+        for (int k = 0; k < longest; k++)
+        {
+#ifdef ROLLUP_X86
+            if (simd)
+            {
+                dock_StepLanesAvx2(m, &l.x[t], &l.y[t], &l.vx[t], &l.vy[t], &l.steps[t], k, w);
+                continue;
+            }
+#endif
+            dock_StepLanes(m, &l.x[t], &l.y[t], &l.vx[t], &l.vy[t], &l.steps[t], k, w);
+        }
+        taken += (long long)longest * w;
+    }
+    (void)simd;
+    return taken;
+}
+
+// out = a * b for 4x4 matrices, out may not alias a or b
+inline void dock_Mul(const double a[4][4], const double b[4][4], double out[4][4])
+{
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            out[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j] + a[i][3] * b[3][j];
+}
+
+// The matrix of steps steps in a row, by repeated squaring
+inline void dock_Power(const DockModel &m, int steps, double out[4][4])
+{
+    double base[4][4], t[4][4];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+        {
+            base[i][j] = m.phi[i][j];
+            out[i][j] = (i == j);
+        }
+    for (; steps > 0; steps >>= 1)
+    {
+        if (steps & 1)
+        {
+            dock_Mul(out, base, t);
+            std::copy(&t[0][0], &t[0][0] + 16, &out[0][0]);
+        }
+        dock_Mul(base, base, t);
+        std::copy(&t[0][0], &t[0][0] + 16, &base[0][0]);
+    }
+}
+
+// Searches coasts x transfers two-burn approaches from s: coast times from 0 to maxCoast
+// and transfer times from minTransfer to maxTransfer, in seconds. lanes is scratch space
+// kept by the caller so repeated plans reuse its buffers.
+inline DockPlan dock_Plan(const DockModel &m, const DockState &s, int coasts, int transfers, double maxCoast, double minTransfer, double maxTransfer, DockLanes &lanes)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    DockPlan best;
+    coasts = std::max(1, coasts);
+    transfers = std::max(1, transfers);
+    int n = coasts * transfers;
+    lanes.x.assign(n, s.x);
+    lanes.y.assign(n, s.y);
+    lanes.vx.assign(n, s.vx);
+    lanes.vy.assign(n, s.vy);
+    lanes.steps.resize(n);
+
+    auto at = [&](int k, int count, double lo, double hi)
+    {
+        double t = (count == 1 ? lo : lo + (hi - lo) * k / (count - 1));
+        return std::max(0, (int)std::lround(t / m.dt));
+    };
+    // Position rows of the matrix of each transfer: where it ends from a given start
+    std::vector<int> transferSteps(transfers);
+    std::vector<double> rows(transfers * 8);
+    for (int j = 0; j < transfers; j++)
+    {
+        transferSteps[j] = std::max(1, at(j, transfers, minTransfer, maxTransfer));
+        double p[4][4];
+        dock_Power(m, transferSteps[j], p);
+        std::copy(&p[0][0], &p[0][0] + 8, &rows[j * 8]);
+    }
+
+    // Coast
+    for (int k = 0; k < coasts; k++)
+        for (int j = 0; j < transfers; j++)
+            lanes.steps[k * transfers + j] = at(k, coasts, 0, maxCoast);
+    best.steps += dock_Fly(m, lanes);
+
+    // First burn: the velocity that brings the position to the origin after the transfer
+    std::vector<double> &dv = lanes.dv;
+    dv.resize(n * 2);
+    for (int i = 0; i < n; i++)
+    {
+        const double *p = &rows[(i % transfers) * 8];
+        double a00 = p[0], a01 = p[1], b00 = p[2], b01 = p[3];
+        double a10 = p[4], a11 = p[5], b10 = p[6], b11 = p[7];
+        double rx = -(a00 * lanes.x[i] + a01 * lanes.y[i]);
+        double ry = -(a10 * lanes.x[i] + a11 * lanes.y[i]);
+        double det = b00 * b11 - b01 * b10;
+        double vx = lanes.vx[i], vy = lanes.vy[i];
+        if (std::fabs(det) > 1e-9)
+        {
+            vx = (b11 * rx - b01 * ry) / det;
+            vy = (b00 * ry - b10 * rx) / det;
+        }
+        else
+            lanes.steps[i] = -1; // The transfer cannot be aimed, e.g. a whole orbit
+        dv[i * 2] = vx - lanes.vx[i];
+        dv[i * 2 + 1] = vy - lanes.vy[i];
+        lanes.vx[i] = vx;
+        lanes.vy[i] = vy;
+    }
+
+    // Transfer
+    for (int i = 0; i < n; i++)
+        lanes.steps[i] = (lanes.steps[i] < 0 ? 0 : transferSteps[i % transfers]);
+    best.steps += dock_Fly(m, lanes);
+    best.evaluated = n;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (lanes.steps[i] == 0)
+            continue;
+        double miss = std::hypot(lanes.x[i], lanes.y[i]);
+        double fuel = std::hypot(dv[i * 2], dv[i * 2 + 1]) + std::hypot(lanes.vx[i], lanes.vy[i]);
+        if (miss > DOCK_MISS || (best.found && fuel >= best.fuel))
+            continue;
+        best.found = true;
+        best.coast = at(i / transfers, coasts, 0, maxCoast);
+        best.transfer = transferSteps[i % transfers];
+        best.dv1x = dv[i * 2];
+        best.dv1y = dv[i * 2 + 1];
+        best.dv2x = -lanes.vx[i];
+        best.dv2y = -lanes.vy[i];
+        best.fuel = fuel;
+        best.miss = miss;
+    }
+    best.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return best;
+}
+
+#endif
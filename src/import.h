@@ -0,0 +1,166 @@
+/**
+ * @file import.h
+ * @brief Streaming bulk import of external CSV files into the NMS tables.
+ *
+ * @details
+ * The file is read in chunks of IMPORT_CHUNK_BYTES, so its size is bounded by the rows it
+ * yields, not by memory for the raw text. The complete lines of a chunk are split into
+ * blocks that are validated on all cores (see parallel.h); each line is either converted to
+ * a row or rejected with a reason. Rejected lines are written, with their line number and
+ * reason, to a side file in the order they appeared.
+ *
+ * Nothing is written to a table here. The accepted rows are returned to the caller, which
+ * appends them once the whole file has been read, so a file that cannot be read part way
+ * through leaves the table untouched.
+ */
+
+#ifndef NMS_IMPORT_H
+#define NMS_IMPORT_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "csv.h"
+#include "parallel.h"
+#include "table.h"
+
+const size_t IMPORT_CHUNK_BYTES = 8u << 20;
+const int IMPORT_BLOCK_LINES = 4096;
+
+struct ImportResult
+{
+    bool opened = false;   // False when the file could not be read, nothing was accepted
+    long long lines = 0;   // Data lines seen, the header not counted
+    long long accepted = 0;
+    long long rejected = 0;
+};
+
+// Column labels of a table as a CSV line, the header an import file may start with
+template <class... Cols>
+std::string import_Header(const Table<Cols...> &)
+{
+    std::string h;
+    ((h += (h.empty() ? "" : ","), h += Cols::name), ...);
+    return h;
+}
+
+// Reads a number within [min, max], the range the menus accept for the same field
+inline bool import_Number(std::string_view f, double min, double max, double &out)
+{
+    return csv_Field(f, out) && out >= min && out <= max;
+}
+
+// Streams the CSV at path through validate and appends the rows it accepts to accepted.
+// validate(fields, row) gets the n fields of one line and returns nullptr when it filled row,
+// or the reason the line is rejected. A first line equal to header is skipped. Rejected lines
+// go to rejectsPath as "line,reason,text"; the file is only left behind when a line was rejected.
+template <class Row, class Validate>
+ImportResult import_Csv(const std::string &path, const std::string &rejectsPath, std::string_view header, size_t n, Validate validate, std::vector<Row> &accepted)
+{
+    ImportResult res;
+    // A rejects file from an earlier import would pass for this one's
+    std::remove(rejectsPath.c_str());
+    FILE *in = std::fopen(path.c_str(), "rb");
+    if (!in)
+        return res;
+    FILE *rejects = nullptr;
+    std::vector<Row> staged;
+
+    std::string buf;
+    std::string carry; // Unfinished last line of the previous chunk
+    std::vector<std::string_view> lines;
+    std::vector<Row> rows;
+    std::vector<const char *> reasons;
+    long long lineNo = 0;
+    bool first = true, failed = false;
+    int threads = parallel_Threads(1 << 30);
+    while (true)
+    {
+        buf = carry;
+        size_t keep = buf.size();
+        buf.resize(keep + IMPORT_CHUNK_BYTES);
+        size_t got = std::fread(&buf[keep], 1, IMPORT_CHUNK_BYTES, in);
+        buf.resize(keep + got);
+        bool last = (got < IMPORT_CHUNK_BYTES);
+        if (last && std::ferror(in))
+        {
+            failed = true;
+            break;
+        }
+
+        // Whole lines only, the rest waits for the next chunk
+        size_t end = last ? buf.size() : buf.rfind('\n') + 1;
+        if (!last && end == 0)
+            end = buf.size(); // A single line longer than a chunk
+        carry.assign(buf, end, std::string::npos);
+        std::string_view rest(buf.data(), end), line;
+        lines.clear();
+        while (csv_NextLine(rest, line))
+        {
+            if (first)
+            {
+                first = false;
+                lineNo++;
+                if (line == header)
+                    continue;
+                lineNo--;
+            }
+            lines.push_back(line);
+        }
+
+        int count = (int)lines.size();
+        rows.assign(count, Row());
+        reasons.assign(count, nullptr);
+        int blocks = (count + IMPORT_BLOCK_LINES - 1) / IMPORT_BLOCK_LINES;
+        parallel_For(blocks, threads, [&](int b)
+                     {
+                         std::vector<std::string_view> fields(n);
+                         int stop = std::min(count, (b + 1) * IMPORT_BLOCK_LINES);
+                         for (int i = b * IMPORT_BLOCK_LINES; i < stop; i++)
+                         {
+                             if (lines[i].empty())
+                                 reasons[i] = "empty line";
+                             else if (!csv_Split(lines[i], fields.data(), n) || fields[n - 1].find(',') != std::string_view::npos)
+                                 reasons[i] = "wrong number of fields";
+                             else
+                                 reasons[i] = validate(fields.data(), rows[i]);
+                         } });
+
+        for (int i = 0; i < count; i++)
+        {
+            lineNo++;
+            res.lines++;
+            if (!reasons[i])
+            {
+                staged.push_back(std::move(rows[i]));
+                continue;
+            }
+            res.rejected++;
+            if (!rejects)
+                rejects = std::fopen(rejectsPath.c_str(), "wb");
+            if (rejects)
+                std::fprintf(rejects, "%lld,%s,%.*s\n", lineNo, reasons[i], (int)lines[i].size(), lines[i].data());
+        }
+        if (last)
+            break;
+    }
+    std::fclose(in);
+    if (rejects)
+        std::fclose(rejects);
+    if (failed)
+        return ImportResult();
+
+    res.opened = true;
+    res.accepted = (long long)staged.size();
+    if (accepted.empty())
+        accepted.swap(staged);
+    else
+        accepted.insert(accepted.end(), std::make_move_iterator(staged.begin()), std::make_move_iterator(staged.end()));
+    return res;
+}
+
+#endif
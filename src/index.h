@@ -0,0 +1,264 @@
+/**
+ * @file index.h
+ * @brief Lookup indexes kept alongside the NMS tables.
+ *
+ * @details
+ * A HashIndex maps the values of one string column to their row, so finding a row by key
+ * costs a hash and usually one compare instead of a scan of the whole column. It is an
+ * open-addressing table with linear probing that stores the row and the key's hash in each
+ * slot; the keys themselves stay in the column and are only read to confirm a match.
+ *
+ * A Bloom filter sits in front of the slots. A key that was never inserted is usually
+ * rejected by the filter without touching the slots at all, which is the common case when
+ * checking whether a new username is free.
+ *
+ * A RowSetIndex groups rows by the value of a column (e.g. every mission with status
+ * "Pending"), keeping each group as a sorted list of rows. Listing a group costs time in
+ * the size of the group, not of the table.
+ *
+ * Neither index watches its column. Callers insert new rows, record value changes and
+ * remove deleted rows themselves, and rebuild the index whenever the table is loaded.
+ */
+
+#ifndef NMS_INDEX_H
+#define NMS_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+const int INDEX_BLOOM_PROBES = 3;
+
+struct IndexSlot
+{
+    std::uint64_t hash = 0;
+    int row = -1; // -1 marks an empty slot
+};
+
+struct HashIndex
+{
+    std::vector<IndexSlot> slots;       // Power-of-two size, at most half full
+    std::vector<std::uint64_t> bloom;   // 8 filter bits per slot, so at least 16 per key
+    int count = 0;
+};
+
+inline std::uint64_t index_Hash(std::string_view key)
+{
+    // Spread the bits so both the slot and the filter probes use well-mixed values
+    std::uint64_t h = std::hash<std::string_view>()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+inline void index_BloomAdd(HashIndex &ix, std::uint64_t h)
+{
+    std::uint64_t bits = (std::uint64_t)ix.bloom.size() * 64;
+    std::uint64_t step = (h >> 32) | 1;
+    for (int k = 0; k < INDEX_BLOOM_PROBES; k++, h += step)
+    {
+        std::uint64_t b = h & (bits - 1);
+        ix.bloom[b >> 6] |= 1ull << (b & 63);
+    }
+}
+
+// False when the key was certainly never inserted
+inline bool index_MayContain(const HashIndex &ix, std::uint64_t h)
+{
+    if (ix.bloom.empty())
+        return false;
+    std::uint64_t bits = (std::uint64_t)ix.bloom.size() * 64;
+    std::uint64_t step = (h >> 32) | 1;
+    for (int k = 0; k < INDEX_BLOOM_PROBES; k++, h += step)
+    {
+        std::uint64_t b = h & (bits - 1);
+        if (!(ix.bloom[b >> 6] & (1ull << (b & 63))))
+            return false;
+    }
+    return true;
+}
+
+// Places a slot without checking the load, the caller has made room
+inline void index_Place(HashIndex &ix, const IndexSlot &s)
+{
+    std::size_t mask = ix.slots.size() - 1;
+    std::size_t i = (std::size_t)s.hash & mask;
+    while (ix.slots[i].row >= 0)
+        i = (i + 1) & mask;
+    ix.slots[i] = s;
+    index_BloomAdd(ix, s.hash);
+}
+
+// Resizes the slot table to hold at least n keys and rebuilds the filter, which also drops
+// the keys erased since the last rebuild from it
+inline void index_Reserve(HashIndex &ix, int n)
+{
+    std::size_t size = 16;
+    while (size < (std::size_t)n * 2)
+        size *= 2;
+    if (size <= ix.slots.size())
+        return;
+    std::vector<IndexSlot> old;
+    old.swap(ix.slots);
+    ix.slots.assign(size, IndexSlot());
+    ix.bloom.assign(size / 8, 0);
+    for (const IndexSlot &s : old)
+        if (s.row >= 0)
+            index_Place(ix, s);
+}
+
+// Adds row under key
+inline void index_Insert(HashIndex &ix, std::string_view key, int row)
+{
+    index_Reserve(ix, ix.count + 1);
+    index_Place(ix, IndexSlot{index_Hash(key), row});
+    ix.count++;
+}
+
+// Indexes the rows of a string column (Column<std::string> or Column<DictString>) for which
+// live(row) is true, so removed rows (see table_Kill) stay out of the index
+template <class Col, class Live>
+void index_Build(HashIndex &ix, const Col &keys, Live live)
+{
+    ix = HashIndex();
+    index_Reserve(ix, keys.size());
+    ix.count = 0;
+    for (int i = 0; i < keys.size(); i++)
+        if (live(i))
+        {
+            index_Place(ix, IndexSlot{index_Hash(keys[i]), i});
+            ix.count++;
+        }
+}
+
+// Indexes every row of a string column
+template <class Col>
+void index_Build(HashIndex &ix, const Col &keys)
+{
+    index_Build(ix, keys, [](int)
+                { return true; });
+}
+
+// Lowest row holding key, -1 when there is none. Equal keys share a probe chain, so the
+// whole chain is checked.
+template <class Col>
+int index_Find(const HashIndex &ix, const Col &keys, std::string_view key)
+{
+    std::uint64_t h = index_Hash(key);
+    if (!index_MayContain(ix, h))
+        return -1;
+    std::size_t mask = ix.slots.size() - 1;
+    int found = -1;
+    for (std::size_t i = (std::size_t)h & mask; ix.slots[i].row >= 0; i = (i + 1) & mask)
+    {
+        const IndexSlot &s = ix.slots[i];
+        if (s.hash == h && (found < 0 || s.row < found) && keys[s.row] == key)
+            found = s.row;
+    }
+    return found;
+}
+
+// Removes row from the index, before the row is cleared. keys must still hold the row.
+template <class Col>
+void index_Remove(HashIndex &ix, const Col &keys, int row)
+{
+    if (ix.slots.empty())
+        return;
+    std::size_t mask = ix.slots.size() - 1;
+    std::size_t i = (std::size_t)index_Hash(keys[row]) & mask;
+    while (ix.slots[i].row >= 0 && ix.slots[i].row != row)
+        i = (i + 1) & mask;
+    if (ix.slots[i].row != row)
+        return;
+    // Backward-shift deletion: pull later members of the chain into the hole so no
+    // lookup stops early at it
+    ix.slots[i] = IndexSlot();
+    for (std::size_t j = (i + 1) & mask; ix.slots[j].row >= 0; j = (j + 1) & mask)
+    {
+        std::size_t home = (std::size_t)ix.slots[j].hash & mask;
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            ix.slots[i] = ix.slots[j];
+            ix.slots[j] = IndexSlot();
+            i = j;
+        }
+    }
+    ix.count--;
+}
+
+struct RowSetIndex
+{
+    std::map<std::string, std::vector<int>, std::less<>> sets; // Value -> rows holding it, ascending
+};
+
+// Groups the rows of a string column for which live(row) is true by value
+template <class Col, class Live>
+void rowset_Build(RowSetIndex &ix, const Col &keys, Live live)
+{
+    ix.sets.clear();
+    for (int i = 0; i < keys.size(); i++)
+    {
+        if (!live(i))
+            continue;
+        std::string_view k = keys[i];
+        auto it = ix.sets.find(k);
+        if (it == ix.sets.end())
+            it = ix.sets.emplace(std::string(k), std::vector<int>()).first;
+        it->second.push_back(i);
+    }
+}
+
+// Groups every row of a string column by value
+template <class Col>
+void rowset_Build(RowSetIndex &ix, const Col &keys)
+{
+    rowset_Build(ix, keys, [](int)
+                 { return true; });
+}
+
+// Rows holding key in ascending order
+inline const std::vector<int> &rowset_Rows(const RowSetIndex &ix, std::string_view key)
+{
+    static const std::vector<int> none;
+    auto it = ix.sets.find(key);
+    return it == ix.sets.end() ? none : it->second;
+}
+
+inline void rowset_Insert(RowSetIndex &ix, std::string_view key, int row)
+{
+    auto it = ix.sets.find(key);
+    if (it == ix.sets.end())
+        it = ix.sets.emplace(std::string(key), std::vector<int>()).first;
+    std::vector<int> &rows = it->second;
+    rows.insert(std::lower_bound(rows.begin(), rows.end(), row), row);
+}
+
+inline void rowset_Remove(RowSetIndex &ix, std::string_view key, int row)
+{
+    auto it = ix.sets.find(key);
+    if (it == ix.sets.end())
+        return;
+    std::vector<int> &rows = it->second;
+    auto pos = std::lower_bound(rows.begin(), rows.end(), row);
+    if (pos != rows.end() && *pos == row)
+        rows.erase(pos);
+    if (rows.empty())
+        ix.sets.erase(it);
+}
+
+// Records that row changed its value from one key to another
+inline void rowset_Move(RowSetIndex &ix, std::string_view from, std::string_view to, int row)
+{
+    if (from == to)
+        return;
+    rowset_Remove(ix, from, row);
+    rowset_Insert(ix, to, row);
+}
+
+#endif
@@ -0,0 +1,409 @@
+/**
+ * @file journal.h
+ * @brief Incremental persistence for the NMS CSV tables.
+ *
+ * @details
+ * Each table file is a base CSV plus a delta file. Mutations mark the rows they touch,
+ * and a save appends only those rows to the delta instead of rewriting the table:
+ *
+ *   P,<row>,<fields>   row <row> now holds <fields> (row == count appends)
+ *   T,<row>            row <row> was deleted and left as a tombstone, no other row moves
+ *   D,<row>            row <row> was removed and later rows moved up by one
+ *   H,<header>         the table header changed (e.g. the agency budget)
+ *
+ * A tombstone is written to the base file as an empty line.
+ *
+ * Once the delta holds more records than the base has rows, the table is compacted: the
+ * rows are serialized on the caller's thread and written to a new base by a background
+ * thread, then renamed over the old one. The base header ends with an epoch number and
+ * the delta of epoch E is named <base>.E.delta, so loading replays the deltas of epoch E
+ * and E+1. That keeps the files consistent if the program stops mid-compaction.
+ */
+
+#ifndef NMS_JOURNAL_H
+#define NMS_JOURNAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "csv.h"
+
+const long long JOURNAL_MIN_COMPACT = 64;
+
+struct Journal
+{
+    std::string path;               // Base CSV file
+    int headerFields = 1;           // Header fields written by the table itself, the epoch follows them
+    long long epoch = 0;            // Epoch of the delta currently appended to
+    long long baseRows = 0;         // Rows in the base file
+    long long diskRows = -1;        // Rows after replaying base and delta, -1 before the first load/save
+    long long deltaRecords = 0;     // Records in the active delta
+    bool outOfStep = false;         // The last load dropped rows, the row numbers on disk are not the table's
+    std::string header;             // Header as last persisted, without the epoch
+    std::ofstream delta;            // Open append handle of the active delta
+    std::vector<int> dirty;         // Rows changed since the last save
+    std::vector<char> isDirty;      // Dirty flag per row
+    std::vector<int> deleted;       // Rows removed since the last save, in order
+    std::vector<CsvError> errors;   // Malformed rows found by the last load
+    std::vector<int> tombstones;    // Rows the last load found deleted
+    std::shared_ptr<std::atomic<bool>> compacting = std::make_shared<std::atomic<bool>>(false);
+
+    Journal(const std::string &file, int fields) : path(file), headerFields(fields) {}
+};
+
+inline std::string journal_DeltaPath(const Journal &j, long long epoch)
+{
+    return j.path + "." + std::to_string(epoch) + ".delta";
+}
+
+// Splits the base header into the table's own fields and the trailing epoch
+inline std::string journal_SplitHeader(const Journal &j, const std::string &line, long long &epoch)
+{
+    epoch = 0;
+    int fields = 1;
+    size_t last = std::string::npos;
+    for (size_t i = 0; i < line.size(); i++)
+        if (line[i] == ',')
+        {
+            fields++;
+            last = i;
+        }
+    if (fields > j.headerFields && last != std::string::npos)
+    {
+        epoch = std::atoll(line.c_str() + last + 1);
+        return line.substr(0, last);
+    }
+    return line;
+}
+
+// Applies one delta file to the rows, returns the number of records it held
+inline long long journal_Replay(const std::string &file, CsvData &data)
+{
+    int source = csv_AddFile(data, file);
+    if (source < 0)
+        return 0;
+    std::string_view rest = data.buffers.back(), line;
+    long long records = 0;
+    for (long long n = 1; csv_NextLine(rest, line); n++)
+    {
+        if (line.size() < 2 || line[1] != ',')
+            continue;
+        records++;
+        if (line[0] == 'H')
+        {
+            data.header = line.substr(2);
+            continue;
+        }
+        long long row = -1;
+        std::from_chars(line.data() + 2, line.data() + line.size(), row);
+        size_t p = line.find(',', 2);
+        if (row < 0 || row > (long long)data.rows.size())
+            continue;
+        if ((line[0] == 'P' && p != std::string_view::npos) || line[0] == 'T')
+        {
+            CsvLine l{std::string_view(), source, n, true};
+            if (line[0] == 'P')
+                l = CsvLine{line.substr(p + 1), source, n};
+            if (row == (long long)data.rows.size())
+                data.rows.push_back(l);
+            else
+                data.rows[row] = l;
+        }
+        else if (line[0] == 'D' && row < (long long)data.rows.size())
+            data.rows.erase(data.rows.begin() + row);
+    }
+    return records;
+}
+
+// Reads the base file and replays its deltas. Returns false when the table was never saved.
+// data.header is returned without the epoch, data.rows are the table lines in order and
+// point into the file buffers held by data.
+inline bool journal_Load(Journal &j, CsvData &data)
+{
+    data = CsvData();
+    j.errors.clear();
+    j.tombstones.clear();
+    int source = csv_AddFile(data, j.path);
+    if (source < 0)
+        return false;
+
+    std::string_view rest = data.buffers.back(), line;
+    long long baseEpoch = 0;
+    if (csv_NextLine(rest, line))
+    {
+        std::string header = journal_SplitHeader(j, std::string(line), baseEpoch);
+        data.header = line.substr(0, header.size());
+    }
+    long long cnt = std::atoll(std::string(data.header).c_str());
+    for (long long i = 0; i < cnt && csv_NextLine(rest, line); i++)
+        data.rows.push_back({line, source, i + 2, line.empty()});
+    j.baseRows = (long long)data.rows.size();
+
+    j.epoch = baseEpoch;
+    j.deltaRecords = journal_Replay(journal_DeltaPath(j, baseEpoch), data);
+    std::ifstream next(journal_DeltaPath(j, baseEpoch + 1));
+    if (next.is_open())
+    {
+        next.close();
+        j.epoch = baseEpoch + 1;
+        j.deltaRecords = journal_Replay(journal_DeltaPath(j, baseEpoch + 1), data);
+    }
+    j.header = std::string(data.header);
+    j.diskRows = (long long)data.rows.size();
+    return true;
+}
+
+inline std::string journal_RejectsPath(const Journal &j)
+{
+    return j.path + ".rejects";
+}
+
+// Parses the loaded rows into the table's columns, see csv_Parse; deleted rows are listed
+// in j.tombstones. When rows had to be dropped the row numbers on disk no longer match the
+// table and j.outOfStep is set: the caller must save right away, which rewrites the base,
+// before any record or snapshot refers to those row numbers. The dropped lines are appended
+// to the rejects file first, as "file,line,reason,text", so the rewrite loses nothing.
+template <class... Cols>
+int journal_Parse(Journal &j, const CsvData &data, int maxRows, Cols &...cols)
+{
+    int count = csv_Parse(data, maxRows, j.errors, j.tombstones, cols...);
+    j.outOfStep = count < (int)data.rows.size();
+    std::string buf;
+    for (const CsvError &e : j.errors)
+        for (size_t p = 0, q; (q = e.text.find('\n', p)) != std::string::npos; p = q + 1)
+            buf += e.file + "," + std::to_string(e.line) + "," + e.message + "," + e.text.substr(p, q - p + 1);
+    if (!buf.empty())
+    {
+        std::ofstream out(journal_RejectsPath(j), std::ios::binary | std::ios::app);
+        out << buf;
+    }
+    return count;
+}
+
+// Takes over the files of a table whose rows were restored from somewhere else (the snapshot),
+// so later saves continue the existing delta instead of rewriting the base
+inline void journal_Attach(Journal &j, long long rows, const std::string &header)
+{
+    std::ifstream f(j.path);
+    std::string line;
+    long long baseEpoch = 0;
+    if (f.is_open() && getline(f, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        j.baseRows = std::atoll(journal_SplitHeader(j, line, baseEpoch).c_str());
+    }
+    j.epoch = baseEpoch;
+    std::ifstream next(journal_DeltaPath(j, baseEpoch + 1));
+    if (next.is_open())
+        j.epoch = baseEpoch + 1;
+    next.close();
+
+    j.deltaRecords = 0;
+    std::ifstream d(journal_DeltaPath(j, j.epoch));
+    while (d.is_open() && getline(d, line))
+        j.deltaRecords++;
+    j.header = header;
+    j.diskRows = f.is_open() ? rows : -1;
+}
+
+// Fingerprint of the base file and the deltas a load would replay, changes with any write to them.
+// 0 while the journal is out of step, so no snapshot taken then ever matches the files.
+inline uint64_t journal_Stamp(const Journal &j)
+{
+    if (j.outOfStep)
+        return 0;
+    std::ifstream f(j.path);
+    std::string line;
+    long long epoch = 0;
+    if (f.is_open() && getline(f, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        journal_SplitHeader(j, line, epoch);
+    }
+    uint64_t h = 1469598103934665603ull;
+    std::string files[] = {j.path, journal_DeltaPath(j, epoch), journal_DeltaPath(j, epoch + 1)};
+    for (const std::string &p : files)
+    {
+        std::error_code ec;
+        uint64_t size = std::filesystem::file_size(p, ec);
+        uint64_t time = ec ? 0 : (uint64_t)std::filesystem::last_write_time(p, ec).time_since_epoch().count();
+        if (ec)
+            size = ~0ull;
+        h = (h ^ size) * 1099511628211ull;
+        h = (h ^ time) * 1099511628211ull;
+    }
+    return h;
+}
+
+// Waits for a running background compaction to finish
+inline void journal_Wait(const Journal &j)
+{
+    while (j.compacting->load())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+// Marks a row as changed or appended
+inline void journal_Touch(Journal &j, int row)
+{
+    if ((int)j.isDirty.size() <= row)
+        j.isDirty.resize(row + 1, 0);
+    if (!j.isDirty[row])
+    {
+        j.isDirty[row] = 1;
+        j.dirty.push_back(row);
+    }
+}
+
+// Records that a row was removed and the rows after it moved up by one
+inline void journal_Delete(Journal &j, int row)
+{
+    // Trimming the last row renumbers nothing: drop its flag and leave the stale entry in
+    // dirty for journal_Save to skip, instead of rebuilding the list for every row
+    if ((int)j.isDirty.size() <= row + 1)
+    {
+        j.isDirty.resize(std::min((int)j.isDirty.size(), row));
+        if (row < j.diskRows)
+        {
+            j.deleted.push_back(row);
+            j.diskRows--;
+        }
+        return;
+    }
+    // Entries the fast path left behind are skipped here just as journal_Save skips them
+    std::vector<int> moved;
+    for (int r : j.dirty)
+    {
+        if (r >= (int)j.isDirty.size() || !j.isDirty[r])
+            continue;
+        j.isDirty[r] = 0;
+        if (r != row)
+            moved.push_back(r > row ? r - 1 : r);
+    }
+    j.dirty.clear();
+    for (int r : moved)
+        journal_Touch(j, r);
+    // Rows past diskRows were appended after the last save and never reached the disk
+    if (row < j.diskRows)
+    {
+        j.deleted.push_back(row);
+        j.diskRows--;
+    }
+}
+
+// Rewrites the base file from every row, the file work happens on a background thread
+inline void journal_Compact(Journal &j, const std::string &header, int count, const std::function<std::string(int)> &row)
+{
+    long long next = j.epoch + 1;
+    std::string buf = header + "," + std::to_string(next) + "\n";
+    for (int i = 0; i < count; i++)
+    {
+        buf += row(i);
+        buf += '\n';
+    }
+
+    // New records go to the next epoch's delta while the base is being replaced
+    long long old = j.epoch;
+    j.delta.close();
+    j.epoch = next;
+    j.delta.open(journal_DeltaPath(j, next), std::ios::trunc);
+    j.deltaRecords = 0;
+    j.baseRows = count;
+    j.outOfStep = false;
+
+    std::string path = j.path;
+    std::string oldDelta = journal_DeltaPath(j, old);
+    std::string olderDelta = journal_DeltaPath(j, old - 1);
+    std::shared_ptr<std::atomic<bool>> flag = j.compacting;
+    flag->store(true);
+    std::thread([path, oldDelta, olderDelta, flag, buf = std::move(buf)]()
+                {
+                    std::string tmp = path + ".tmp";
+                    {
+                        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                        out.write(buf.data(), buf.size());
+                        if (!out)
+                        {
+                            flag->store(false);
+                            return;
+                        }
+                    }
+                    std::error_code ec;
+                    std::filesystem::rename(tmp, path, ec);
+                    if (!ec)
+                    {
+                        std::remove(oldDelta.c_str());
+                        std::remove(olderDelta.c_str());
+                    }
+                    flag->store(false);
+                })
+        .detach();
+}
+
+// Persists the rows marked since the last save. header is the table header without the epoch,
+// row(i) serializes row i, or returns "" when row i is a tombstone. Falls back to a
+// compaction when the delta has outgrown the base or the journal is out of step.
+inline void journal_Save(Journal &j, const std::string &header, int count, const std::function<std::string(int)> &row)
+{
+    bool fresh = (j.diskRows < 0);
+    if (fresh)
+    {
+        std::ifstream f(j.path);
+        fresh = !f.is_open();
+    }
+    bool due = j.deltaRecords > std::max(JOURNAL_MIN_COMPACT, j.baseRows);
+    if (fresh || ((due || j.outOfStep) && !j.compacting->load()))
+        journal_Compact(j, header, count, row);
+    else
+    {
+        if (!j.delta.is_open())
+            j.delta.open(journal_DeltaPath(j, j.epoch), std::ios::app);
+        std::string buf;
+        std::sort(j.dirty.begin(), j.dirty.end());
+        j.dirty.erase(std::unique(j.dirty.begin(), j.dirty.end()), j.dirty.end());
+        for (int r : j.deleted)
+        {
+            buf += "D," + std::to_string(r) + "\n";
+            j.deltaRecords++;
+        }
+        for (int r : j.dirty)
+        {
+            if (r >= count || r >= (int)j.isDirty.size() || !j.isDirty[r])
+                continue;
+            std::string text = row(r);
+            if (text.empty())
+                buf += "T," + std::to_string(r) + "\n";
+            else
+                buf += "P," + std::to_string(r) + "," + text + "\n";
+            j.deltaRecords++;
+        }
+        if (header != j.header)
+        {
+            buf += "H," + header + "\n";
+            j.deltaRecords++;
+        }
+        j.delta << buf;
+        j.delta.flush();
+    }
+
+    for (int r : j.dirty)
+        if (r < (int)j.isDirty.size())
+            j.isDirty[r] = 0;
+    j.dirty.clear();
+    j.deleted.clear();
+    j.header = header;
+    j.diskRows = count;
+}
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file logstore.h
+ * @brief Segmented, append-only audit log used by the NMS System Logs.
+ *
+ * @details
+ * Records are appended to the active segment. When the active segment grows past
+ * LOG_SEGMENT_BYTES it is sealed: a sparse offset index is written beside it, its
+ * record count is appended to the manifest and a new segment is started. Any record
+ * can then be located with one manifest lookup, one index read and a short scan.
+ *
+ * On startup only the manifest and the newest segment are read, and only the last
+ * LOG_TAIL records of that segment are kept in memory.
+ *
+ * FILES:
+ * - nasa_logs.csv       segment 0 (keeps the old name so existing logs carry over)
+ * - nasa_logs.N.csv     segment N
+ * - nasa_logs.N.idx     byte offset of every LOG_INDEX_STRIDE-th record (int64, binary)
+ * - nasa_logs.manifest  record count of each sealed segment, one per line
+ */
+
+#ifndef NMS_LOGSTORE_H
+#define NMS_LOGSTORE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+const long long LOG_SEGMENT_BYTES = 4 * 1024 * 1024;
+const int LOG_INDEX_STRIDE = 256;
+const int LOG_TAIL = 1000;
+
+struct LogStore
+{
+    std::vector<long long> sealedCounts; // Records held by each sealed segment
+    std::vector<long long> sealedStart;  // Global number of the first record of each sealed segment
+    long long total = 0;                 // Records across all segments
+
+    int active = 0;                     // Segment currently appended to
+    std::ofstream out;                  // Open append handle of the active segment
+    long long activeBytes = 0;          // Size of the active segment
+    long long activeCount = 0;          // Records in the active segment
+    std::vector<int64_t> activeIndex;   // Offsets of every stride-th record of the active segment
+    std::deque<std::string> tail;       // Newest records, served without touching the disk
+    bool deferFlush = false;            // Leave records buffered until log_Flush (batch mode)
+};
+
+// File name of a segment or of its index
+inline std::string log_SegmentPath(int seg, const std::string &ext = "csv")
+{
+    if (seg == 0 && ext == "csv")
+        return "nasa_logs.csv";
+    return "nasa_logs." + std::to_string(seg) + "." + ext;
+}
+
+// Segment 0 may still start with the count header written by older builds
+inline bool log_IsLegacyHeader(const std::string &line, int seg, long long offset)
+{
+    return seg == 0 && offset == 0 && !line.empty() && line.find_first_not_of("0123456789") == std::string::npos;
+}
+
+// Reads the manifest and scans the active segment to rebuild its index and tail
+inline void log_Open(LogStore &s)
+{
+    s.sealedCounts.clear();
+    s.sealedStart.clear();
+    s.total = 0;
+
+    std::ifstream m("nasa_logs.manifest");
+    long long c;
+    while (m >> c)
+    {
+        s.sealedStart.push_back(s.total);
+        s.sealedCounts.push_back(c);
+        s.total += c;
+    }
+    s.active = (int)s.sealedCounts.size();
+
+    s.activeBytes = 0;
+    s.activeCount = 0;
+    s.activeIndex.clear();
+    s.tail.clear();
+    std::ifstream f(log_SegmentPath(s.active), std::ios::binary);
+    std::string line;
+    while (f.is_open() && getline(f, line))
+    {
+        long long start = s.activeBytes;
+        s.activeBytes += (long long)line.size() + 1;
+        if (log_IsLegacyHeader(line, s.active, start))
+            continue;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (s.activeCount % LOG_INDEX_STRIDE == 0)
+            s.activeIndex.push_back(start);
+        s.activeCount++;
+        s.tail.push_back(line);
+        if ((int)s.tail.size() > LOG_TAIL)
+            s.tail.pop_front();
+    }
+    s.total += s.activeCount;
+
+    if (s.out.is_open())
+        s.out.close();
+    s.out.open(log_SegmentPath(s.active), std::ios::binary | std::ios::app);
+}
+
+// Seals the active segment and starts the next one
+inline void log_Rotate(LogStore &s)
+{
+    std::ofstream idx(log_SegmentPath(s.active, "idx"), std::ios::binary | std::ios::trunc);
+    idx.write((const char *)s.activeIndex.data(), s.activeIndex.size() * sizeof(int64_t));
+    idx.close();
+    std::ofstream m("nasa_logs.manifest", std::ios::app);
+    m << s.activeCount << '\n';
+    m.close();
+
+    s.sealedStart.push_back(s.total - s.activeCount);
+    s.sealedCounts.push_back(s.activeCount);
+    s.active++;
+    s.activeBytes = 0;
+    s.activeCount = 0;
+    s.activeIndex.clear();
+    s.out.close();
+    s.out.open(log_SegmentPath(s.active), std::ios::binary | std::ios::app);
+}
+
+// Appends one record, rotating first if the active segment is full
+inline void log_Append(LogStore &s, const std::string &action)
+{
+    if (s.activeBytes >= LOG_SEGMENT_BYTES)
+        log_Rotate(s);
+    if (s.activeCount % LOG_INDEX_STRIDE == 0)
+        s.activeIndex.push_back(s.activeBytes);
+    s.out << action << '\n';
+    if (!s.deferFlush)
+        s.out.flush();
+    s.activeBytes += (long long)action.size() + 1;
+    s.activeCount++;
+    s.total++;
+    s.tail.push_back(action);
+    if ((int)s.tail.size() > LOG_TAIL)
+        s.tail.pop_front();
+}
+
+// Writes out records held back by deferFlush
+inline void log_Flush(LogStore &s)
+{
+    s.out.flush();
+}
+
+// Reads up to n records starting at global record number first (0 = oldest)
+inline void log_Read(LogStore &s, long long first, int n, std::vector<std::string> &out)
+{
+    out.clear();
+    if (first < 0)
+        first = 0;
+    long long last = std::min(s.total, first + n);
+    long long tailStart = s.total - (long long)s.tail.size();
+
+    while (first < last && first < tailStart)
+    {
+        // Locate the segment holding the record and the record number inside it
+        int seg;
+        long long local;
+        long long segCount;
+        if (first >= s.total - s.activeCount)
+        {
+            seg = s.active;
+            local = first - (s.total - s.activeCount);
+            segCount = s.activeCount;
+        }
+        else
+        {
+            seg = (int)(std::upper_bound(s.sealedStart.begin(), s.sealedStart.end(), first) - s.sealedStart.begin()) - 1;
+            local = first - s.sealedStart[seg];
+            segCount = s.sealedCounts[seg];
+        }
+
+        int64_t offset = 0;
+        long long slot = local / LOG_INDEX_STRIDE;
+        if (seg == s.active)
+            offset = s.activeIndex[slot];
+        else
+        {
+            std::ifstream idx(log_SegmentPath(seg, "idx"), std::ios::binary);
+            idx.seekg(slot * sizeof(int64_t));
+            idx.read((char *)&offset, sizeof(int64_t));
+        }
+
+        std::ifstream f(log_SegmentPath(seg), std::ios::binary);
+        f.seekg(offset);
+        std::string line;
+        long long at = slot * LOG_INDEX_STRIDE;
+        while (at < segCount && first < last && first < tailStart && getline(f, line))
+        {
+            if (at++ < local)
+                continue;
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            out.push_back(line);
+            first++;
+            local++;
+        }
+        if (!f)
+            return;
+    }
+
+    for (; first < last; first++)
+        out.push_back(s.tail[first - tailStart]);
+}
+
+#endif
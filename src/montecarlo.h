@@ -0,0 +1,123 @@
+/**
+ * @file montecarlo.h
+ * @brief Headless Monte Carlo runs of the launch sequence, spread over all cores.
+ *
+ * @details
+ * A launch checks its subsystems in order and is lost at the first one that fails, as in
+ * sim_Launch. mc_Launch repeats that sequence any number of times without the console and
+ * counts the successes and, for every subsystem, the launches it brought down.
+ *
+ * The runs are cut into blocks of MC_BLOCK_RUNS. Block k draws from the seed's stream jumped
+ * k times (see rng.h), so the counts depend only on the seed and the number of runs, never on
+ * how many threads ran the blocks or in which order. Each thread takes a contiguous range of
+ * blocks, jumps its stream to the first and on by one per block, and keeps its own totals, so
+ * the memory used does not grow with the number of runs.
+ *
+ * The success rate comes with a 95% Wilson score interval, which stays inside [0, 1] and
+ * behaves at rates close to 0 or 1, where the normal approximation does not.
+ */
+
+#ifndef NMS_MONTECARLO_H
+#define NMS_MONTECARLO_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "parallel.h"
+#include "rng.h"
+
+const long long MC_BLOCK_RUNS = 1 << 16;
+const long long MC_MAX_RUNS = 10000000000LL; // Runs mc_Launch does at most, a few minutes on a desktop
+const double MC_Z95 = 1.959963984540054; // Normal quantile of a two-sided 95% interval
+
+struct McLaunchResult
+{
+    long long runs = 0;
+    long long successes = 0;
+    std::vector<long long> failures; // Launches lost at each subsystem
+    double p = 0;                    // Success rate
+    double lo = 0, hi = 0;           // 95% interval of the success rate
+    int threads = 0;
+    double ms = 0;
+};
+
+// Wilson score interval of k successes in n trials
+inline void mc_Wilson(long long k, long long n, double z, double &lo, double &hi)
+{
+    if (n <= 0)
+    {
+        lo = 0;
+        hi = 1;
+        return;
+    }
+    double p = (double)k / n, z2 = z * z / n;
+    double centre = (p + z2 / 2) / (1 + z2);
+    double half = z * std::sqrt(p * (1 - p) / n + z2 / (4 * n)) / (1 + z2);
+    lo = std::max(0.0, centre - half);
+    hi = std::min(1.0, centre + half);
+}
+
+// Share of the launches that reach subsystem s and are lost there
+inline double mc_FailRate(const McLaunchResult &r, size_t s)
+{
+    long long reached = r.runs;
+    for (size_t t = 0; t < s; t++)
+        reached -= r.failures[t];
+    return reached > 0 ? (double)r.failures[s] / reached : 0;
+}
+
+// Runs the launch sequence runs times, fail[s] being the chance subsystem s fails its check
+inline McLaunchResult mc_Launch(const std::vector<double> &fail, long long runs, std::uint64_t seed, int threads)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    McLaunchResult res;
+    size_t systems = fail.size();
+    res.runs = std::max(0LL, std::min(runs, MC_MAX_RUNS));
+    res.failures.assign(systems, 0);
+
+    std::vector<std::uint64_t> limit(systems);
+    for (size_t s = 0; s < systems; s++)
+        limit[s] = rng_Limit(fail[s]);
+
+    long long blocks = (res.runs + MC_BLOCK_RUNS - 1) / MC_BLOCK_RUNS;
+    res.threads = (int)std::max(1LL, std::min((long long)threads, blocks));
+    // Counted per thread, so neighbouring threads do not share cache lines
+    std::vector<std::vector<long long>> lost(res.threads, std::vector<long long>(systems, 0));
+    parallel_For(res.threads, res.threads, [&](int t)
+                 {
+                     long long first = blocks * t / res.threads, last = blocks * (t + 1) / res.threads;
+                     Rng stream = rng_Make(seed);
+                     for (long long b = 0; b < first; b++)
+                         rng_Jump(stream);
+                     std::vector<long long> out(systems, 0);
+                     for (long long b = first; b < last; b++)
+                     {
+                         Rng r = stream;
+                         long long n = std::min(MC_BLOCK_RUNS, res.runs - b * MC_BLOCK_RUNS);
+                         for (long long i = 0; i < n; i++)
+                             for (size_t s = 0; s < systems; s++)
+                                 if (rng_Hit(r, limit[s]))
+                                 {
+                                     out[s]++;
+                                     break;
+                                 }
+                         rng_Jump(stream);
+                     }
+                     lost[t] = out; });
+
+    long long failed = 0;
+    for (const std::vector<long long> &out : lost)
+        for (size_t s = 0; s < systems; s++)
+            res.failures[s] += out[s];
+    for (long long f : res.failures)
+        failed += f;
+    res.successes = res.runs - failed;
+    res.p = res.runs > 0 ? (double)res.successes / res.runs : 0;
+    mc_Wilson(res.successes, res.runs, MC_Z95, res.lo, res.hi);
+    res.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+#endif
@@ -20,7 +20,7 @@
  * 
  * TECHNICAL SPECIFICATIONS:
  * - Language: C++
- * - Platform: Windows (utilizes Win32 API for console manipulation)
+ * - Platform: Windows (Win32 console API) and Linux/POSIX (termios + ANSI), see terminal.h
  * - Storage: Persistent CSV-based flat-file database system.
  * - UI: ANSI-colored console interface with custom coordinate-based rendering.
  */
@@ -28,11 +28,34 @@
 #include <iostream>
 #include <string>
 #include <cstdlib>
-#include <windows.h>
-#include <conio.h>
+#include "terminal.h"
+#ifdef _WIN32
+#include <psapi.h>
+#endif
 #include <iomanip>
 #include <ctime>
 #include <fstream>
+#include <vector>
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include "csv.h"
+#include "logstore.h"
+#include "journal.h"
+#include "snapshot.h"
+#include "parallel.h"
+#include "table.h"
+#include "index.h"
+#include "render.h"
+#include "ui.h"
+#include "import.h"
+#include "pager.h"
+#include "query.h"
+#include "rollup.h"
+#include "rng.h"
+#include "montecarlo.h"
+#include "docking.h"
+#include "pathfind.h"
 
 using namespace std;
 
@@ -47,123 +70,277 @@ const string WHT = "\033[37m";
 const string GRA = "\033[90m";
 const string RST = "\033[0m";
 
-// GLOBAL CONSTANTS
-const int MAX_USERS = 200;
-const int MAX_HIRES = 200;
-const int MAX_MISSIONS = 200;
-const int MAX_INVENTORY = 500;
-const int MAX_ASTRO = 100;
-const int MAX_LOGS = 1000;
-const int MAX_PLANETS = 100;
+// Subsystems checked in order before every launch
+const string launchSystems[] = {"Fuel", "Guidance", "Comms", "Telemetry"};
+// Chance of each subsystem failing its check
+const vector<double> launchFailure = {0.1, 0.1, 0.1, 0.1};
+// Launches simulated for the predicted success rate shown before funding
+const long long LAUNCH_PREDICT_RUNS = 4000000;
+// Integrator shared by the docking sim and its autopilot (see docking.h)
+const DockModel dockModel = dock_Model();
+
+// Table columns (see table.h)
+TABLE_COLUMN(UserName, string, "username");
+TABLE_COLUMN(UserPassword, string, "password");
+TABLE_COLUMN(UserRole, DictString, "role");
+TABLE_COLUMN(UserDept, string, "department");
+using UserTable = Table<UserName, UserPassword, UserRole, UserDept>;
+
+TABLE_COLUMN(HireUser, string, "user");
+TABLE_COLUMN(HireRole, DictString, "role");
+TABLE_COLUMN(HireExp, string, "experience");
+TABLE_COLUMN(HireStatus, DictString, "status");
+TABLE_COLUMN(HireName, string, "name");
+TABLE_COLUMN(HireEdu, string, "education");
+using HireTable = Table<HireUser, HireRole, HireExp, HireStatus, HireName, HireEdu>;
+
+TABLE_COLUMN(MissionName, string, "name");
+TABLE_COLUMN(MissionCode, string, "code");
+TABLE_COLUMN(MissionDate, string, "date");
+TABLE_COLUMN(MissionVehicle, string, "vehicle");
+TABLE_COLUMN(MissionStatus, DictString, "status");
+TABLE_COLUMN(MissionBudget, double, "budget");
+TABLE_COLUMN(MissionRequester, string, "requester");
+TABLE_COLUMN(MissionCost, double, "cost");
+using MissionTable = Table<MissionName, MissionCode, MissionDate, MissionVehicle, MissionStatus, MissionBudget, MissionRequester, MissionCost>;
+
+TABLE_COLUMN(InvName, string, "name");
+TABLE_COLUMN(InvCat, DictString, "category");
+TABLE_COLUMN(InvQty, double, "quantity");
+TABLE_COLUMN(InvUnit, DictString, "unit");
+TABLE_COLUMN(InvCost, double, "cost");
+using InventoryTable = Table<InvName, InvCat, InvQty, InvUnit, InvCost>;
+
+TABLE_COLUMN(AstroName, string, "name");
+TABLE_COLUMN(AstroRank, DictString, "rank");
+TABLE_COLUMN(AstroStatus, DictString, "status");
+using AstroTable = Table<AstroName, AstroRank, AstroStatus>;
+
+TABLE_COLUMN(PlanetName, string, "name");
+TABLE_COLUMN(PlanetType, DictString, "type");
+TABLE_COLUMN(PlanetDist, double, "distance");
+TABLE_COLUMN(PlanetGrav, double, "gravity");
+TABLE_COLUMN(PlanetAtm, string, "atmosphere");
+using PlanetTable = Table<PlanetName, PlanetType, PlanetDist, PlanetGrav, PlanetAtm>;
+
+TABLE_COLUMN(ExoName, string, "name");
+TABLE_COLUMN(ExoDist, double, "distance");
+TABLE_COLUMN(ExoType, DictString, "type");
+TABLE_COLUMN(ExoHabitable, bool, "habitable");
+using ExoplanetTable = Table<ExoName, ExoDist, ExoType, ExoHabitable>;
+
+// Every dataset of the agency
+struct Database
+{
+    UserTable users;
+    HireTable hires;
+    MissionTable missions;
+    double agencyBudget = 50.0; // Billions
+    InventoryTable inventory;
+    AstroTable astronauts;
+    PlanetTable planets;
+    ExoplanetTable exoplanets;
+};
+
+// Load time of one table at boot
+struct LoadTiming
+{
+    string table;
+    double ms;
+    bool snapshot; // Restored from the snapshot instead of parsed from CSV
+};
+
+// Persistence journals, one per table file (see journal.h)
+Journal usersJournal("nasa_users.csv", 1);
+Journal hiresJournal("nasa_hires.csv", 1);
+Journal missionsJournal("nasa_missions.csv", 2);
+Journal invJournal("nasa_inv.csv", 1);
+Journal astroJournal("nasa_astro.csv", 1);
+Journal planetsJournal("nasa_planets.csv", 1);
+Journal exoJournal("nasa_exo.csv", 1);
+
+// Lookup indexes, rebuilt whenever their table is loaded (see index.h)
+HashIndex userIndex;               // Username -> user row
+RowSetIndex missionsByStatus;      // Mission status -> mission rows
+RowSetIndex missionsByRequester;   // Requesting username -> mission rows
+RowSetIndex hiresByUser;           // Applicant username -> application rows
+RowSetIndex hiresByStatus;         // Application status -> rows in row order, not filing order (freed rows are reused)
+
+// Console the menu screens are drawn on (see ui.h)
+UiConsole console;
+
+// Random stream of the session, seeded once at start-up and the seed logged (see rng.h)
+uint64_t rngSeed = 0;
+Rng rng;
+
+// Lowest REQ- number not handed out yet this session; rows are reused, so codes cannot follow them
+int nextRequestCode = 100;
+
+// Launch prediction shown before funding, kept until the failure rates or the run count change
+struct LaunchForecast
+{
+    vector<double> failure;
+    long long runs = -1;
+    McLaunchResult result;
+};
+LaunchForecast launchForecast;
 
 // Functions Prototypes
 // Main Menu
-bool signUp(string username, string password, string usernames[], string passwords[], string roles[], string departments[], int &count, string logActions[], int &logCount);
-int signIn(string username, string password, string usernames[], string passwords[], int count, string logActions[], int &logCount);
+bool signUp(string username, string password, UserTable &users, LogStore &logs);
+int signIn(string username, string password, UserTable &users, LogStore &logs);
 void about();
 void history();
 void exit();
 //   Visuals
 void gotoxy(int x, int y);
 void setCursor(bool visible);
+void clearScreen();
 void drawLogo(bool animate = false);
 void drawBox(int x, int y, int width, int height);
+void addLogo(UiScreen &screen);
+void buildMenu(UiScreen &screen, string title, uint8_t color, int boxHeight, const vector<string> &items);
 void animations(string text, int speed);
 void clearKeyboardBuffer();
-void pause();
+void waitKey();
+int getKey();
 void message(string msg);
+string frameStatus(const FrameStats &stats);
+void pageTable(PagerView &view, long long count, const function<void(long long, PagerRow &)> &row, const function<long long(long long)> &find);
+template <class T>
+vector<int> liveRows(const T &t);
+long long rowPosition(const vector<int> &rows, long long id);
+string formatNumber(double v);
+string formatAmount(double v);
 
 // Initialization
-void init_Database(string usernames[], string passwords[], string roles[], string departments[], int &userCount,
-                   string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                   string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                   string invNames[], string invCats[], double invQtys[], string invUnits[], double invCosts[], int &invCount,
-                   string astroNames[], string astroRanks[], string astroStatus[], int &astroCount,
-                   string planetNames[], string planetTypes[], double planetDists[], double planetGravs[], string planetAtms[], int &planetCount,
-                   string exoNames[], double exoDists[], string exoTypes[], bool exoHabitable[], int &exoCount,
-                   string logActions[], int &logCount);
-
-void init_Users(string usernames[], string passwords[], string roles[], string departments[], int &count);
-void init_Missions(string names[], string codes[], string vehicles[], string status[], double budgets[], string requesters[], double costs[], int &count, string dates[]);
-void init_Inventory(string names[], string cats[], double qtys[], string units[], double costs[], int &count);
-void init_Astronauts(string names[], string ranks[], string status[], int &count);
-void init_Planets(string names[], string types[], double dists[], double gravs[], string atms[], int &count);
-void init_Exoplanets(string names[], double dists[], string types[], bool habitable[], int &count);
+void init_Database(Database &db, LogStore &logs, vector<LoadTiming> &timings);
+
+void init_Users(UserTable &users);
+void init_Missions(MissionTable &missions);
+void init_Inventory(InventoryTable &inv);
+void init_Astronauts(AstroTable &astros);
+void init_Planets(PlanetTable &planets);
+void init_Exoplanets(ExoplanetTable &exos);
 
 // Dashboards
-void dashboard_Main(string usernames[], string passwords[], string roles[], int userLimit, int &currentUserIdx,
-                    string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                    string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                    string invNames[], string invCats[], double invQtys[], string invUnits[], double invCosts[], int &invCount,
-                    string astroNames[], string astroRanks[], string astroStatus[], int &astroCount,
-                    string planetNames[], string planetTypes[], double planetDists[], double planetGravs[], string planetAtms[], int &planetCount,
-                    string exoNames[], double exoDists[], string exoTypes[], bool exoHabitable[], int &exoCount,
-                    string logActions[], int &logCount);
-
-void dashboard_Flight(string usernames[], string roles[], int currentUserIdx,
-                      string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                      string invNames[], double invCosts[], int invCount,
-                      string logActions[], int &logCount);
-void dashboard_Eng(string invNames[], string invCats[], double invQtys[], string invUnits[], double invCosts[], int &invCount, string logActions[], int &logCount);
-void dashboard_Science(string planetNames[], string planetTypes[], double planetDists[], double planetGravs[], string planetAtms[], int &planetCount,
-                       string exoNames[], double exoDists[], string exoTypes[], bool exoHabitable[], int &exoCount,
-                       string logActions[], int &logCount);
-void dashboard_HR(string astroNames[], string astroRanks[], string astroStatus[], int &astroCount);
-void dashboard_Admin(string usernames[], string passwords[], string roles[], int &userCount,
-                     string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                     string missionNames[], string missionStatus[], string missionDates[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                     string astroNames[], string astroRanks[], string astroStatus[], int &astroCount,
-                     string logActions[], int &logCount);
+void dashboard_Main(Database &db, int &currentUserIdx, LogStore &logs);
+void dashboard_Flight(Database &db, int currentUserIdx, LogStore &logs);
+void dashboard_Eng(InventoryTable &inv, LogStore &logs);
+void dashboard_Science(PlanetTable &planets, ExoplanetTable &exos, LogStore &logs);
+void dashboard_HR(AstroTable &astros);
+void dashboard_Admin(Database &db, int &currentUserIdx, LogStore &logs);
+void dashboard_Query(Database &db, int currentUserIdx);
 
 // Internal Features
 
-void flight_Manifest(string names[], string codes[], string dates[], string vehicles[], string status[], string requesters[], int &count);
-void flight_Request(string username, string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount,
-                    string invNames[], double invCosts[], int invCount, string logActions[], int &logCount);
-void sim_Launch(string names[], string vehicles[], string status[], string requesters[], double costs[], int &count, double agencyBudget, string logActions[], int &logCount, string dates[]);
+void flight_Manifest(MissionTable &missions);
+void flight_Request(string username, MissionTable &missions, double agencyBudget, InventoryTable &inv, LogStore &logs);
+void sim_Launch(MissionTable &missions, double agencyBudget, LogStore &logs);
 void sim_Docking();
-void eng_Inventory(string names[], string cats[], double qtys[], double costs[], int &count);
-void eng_RoverBuilder(string logActions[], int &logCount);
-void sci_Planets(string names[], string types[], double dists[], double gravs[], string atms[], int &count);
-void sci_Exoplanets(string names[], double dists[], string types[], bool habitable[], int &count);
-void sci_AddPlanet(string names[], string types[], double dists[], double gravs[], string atms[], int &count);
-void sci_AddExoplanet(string names[], double dists[], string types[], bool habitable[], int &count);
-void sci_Decrypt(string logActions[], int &logCount);
-void hr_Roster(string names[], string ranks[], string status[], int &count);
+DockPlan sim_PlanDocking(const DockState &s, DockLanes &lanes);
+void eng_Inventory(InventoryTable &inv);
+void eng_RoverBuilder(LogStore &logs);
+void sci_Planets(PlanetTable &planets);
+void sci_Exoplanets(ExoplanetTable &exos);
+void sci_AddPlanet(PlanetTable &planets);
+void sci_AddExoplanet(ExoplanetTable &exos);
+void sci_Decrypt(LogStore &logs);
+void hr_Roster(AstroTable &astros);
 void hr_Training();
-void career_Menu(string username, string userRole, string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount, string logActions[], int &logCount);
-void admin_Hiring(string usernames[], string roles[], int userLimit, string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                  string astroNames[], string astroRanks[], string astroStatus[], int &astroCount, string logActions[], int &logCount);
-void admin_Personnel(string usernames[], string passwords[], string roles[], string departments[], int &userCount, string logActions[], int &logCount);
-void admin_Missions(string names[], string status[], string dates[], double budgets[], string requesters[], int &count, double &agencyBudget, string logActions[], int &logCount);
-void flight_DeleteMission(string names[], string status[], string dates[], string requesters[], double costs[], int &count);
-void eng_AddInventory(string names[], string cats[], double qtys[], string units[], double costs[], int &count);
-void eng_DeleteInventory(string names[], string cats[], double qtys[], string units[], double costs[], int &count);
-void sci_DeletePlanet(string names[], string types[], double dists[], double gravs[], string atms[], int &count);
-void sci_DeleteExoplanet(string names[], double dists[], string types[], bool habitable[], int &count);
+void career_Menu(string username, string userRole, HireTable &hires, LogStore &logs);
+void admin_Hiring(UserTable &users, HireTable &hires, AstroTable &astros, LogStore &logs);
+void admin_Personnel(UserTable &users, int &currentUserIdx, LogStore &logs);
+void admin_Logs(LogStore &logs);
+void admin_Missions(MissionTable &missions, double &agencyBudget, LogStore &logs);
+void flight_DeleteMission(MissionTable &missions, double agencyBudget);
+void flight_MyMissions(string username, MissionTable &missions);
+void flight_ManifestRow(MissionTable &missions, int i);
+void eng_AddInventory(InventoryTable &inv);
+void eng_DeleteInventory(InventoryTable &inv);
+void eng_Valuation(InventoryTable &inv);
+void admin_Spend(MissionTable &missions, double agencyBudget);
+void admin_SpendTotals(MissionTable &missions, double &committed, double &pending);
+void sci_DeletePlanet(PlanetTable &planets);
+void sci_DeleteExoplanet(ExoplanetTable &exos);
 void ops_RoverGame();
 
+// Record Operations, shared by the menus and batch mode
+string flight_NextRequestCode(const MissionTable &missions);
+int flight_InsertMission(MissionTable &missions, string username, string name, string vehicle, double cost);
+void flight_SetStatus(MissionTable &missions, int i, string status);
+void flight_RemoveMission(MissionTable &missions, int i);
+bool sim_SystemGo(Rng &r, int system);
+McLaunchResult sim_Predict(long long runs, uint64_t seed);
+string sim_Percent(double p);
+bool admin_FundMission(MissionTable &missions, double &agencyBudget, int i);
+bool admin_ApproveHire(UserTable &users, HireTable &hires, AstroTable &astros, int idx);
+void admin_RejectHire(HireTable &hires, int idx);
+int eng_InsertItem(InventoryTable &inv, string name, string cat, double qty, string unit, double cost);
+void eng_RemoveItem(InventoryTable &inv, int i);
+int sci_InsertPlanet(PlanetTable &planets, string name, string type, double dist, double grav, string atm);
+void sci_RemovePlanet(PlanetTable &planets, int i);
+int hr_InsertAstronaut(AstroTable &astros, string name, string rank, string status);
+int sci_InsertExoplanet(ExoplanetTable &exos, string name, double dist, string type, bool habitable);
+
+// Bulk Import
+ImportResult eng_ImportItems(InventoryTable &inv, string path);
+ImportResult hr_ImportAstronauts(AstroTable &astros, string path);
+ImportResult sci_ImportExoplanets(ExoplanetTable &exos, string path);
+bool importText(string_view field, string &out);
+
+// Queries (see query.h)
+bool runQuery(Database &db, string role, const Query &q, QueryResult &res, string &error);
+string queryTables(Database &db);
+
+// Batch Mode
+int batch_Run(istream &in, Database &db, LogStore &logs);
+string batch_Exec(const vector<string> &words, Database &db, int &currentUserIdx, LogStore &logs);
+vector<string> batch_Words(const string &line);
+bool batch_Number(const string &word, double min, double max, double &out);
+template <class T>
+bool batch_Row(const string &word, const T &t, int &row);
+template <class... Cols>
+bool batch_SetField(Table<Cols...> &t, int row, const string &label, const string &text);
+
 // Storage Modules
-void saveUsers(string usernames[], string passwords[], string roles[], string departments[], int count);
-void loadUsers(string usernames[], string passwords[], string roles[], string departments[], int &count);
-void saveHires(string users[], string roles[], string exp[], string status[], string names[], string edu[], int count);
-void loadHires(string users[], string roles[], string exp[], string status[], string names[], string edu[], int &count);
-void saveMissions(int count, string names[], string status[], string requesters[], double costs[], double budget, string dates[]);
-void loadMissions(int &count, string names[], string codes[], string vehicles[], string status[], double budgets[], string requesters[], double costs[], double &agencyBudget, string dates[]);
-void saveInventory(int count, string names[], string cats[], double qtys[], string units[], double costs[]);
-void loadInventory(int &count, string names[], string cats[], double qtys[], string units[], double costs[]);
-void saveAstronauts(int count, string names[], string ranks[], string status[]);
-void loadAstronauts(int &count, string names[], string ranks[], string status[]);
-void savePlanets(int count, string names[], string types[], double dists[], double gravs[], string atms[]);
-void loadPlanets(int &count, string names[], string types[], double dists[], double gravs[], string atms[]);
-void saveExoplanets(int count, string names[], double dists[], string types[], bool habitable[]);
-void loadExoplanets(int &count, string names[], double dists[], string types[], bool habitable[]);
-void saveLogs(int count, string actions[]);
-void loadLogs(int &count, string actions[]);
-void addLog(string action, string logActions[], int &logCount);
+void saveUsers(UserTable &users);
+template <class T>
+void compactTable(T &t, Journal &j);
+void loadUsers(UserTable &users);
+void saveHires(HireTable &hires);
+void loadHires(HireTable &hires);
+void indexHires(HireTable &hires);
+void saveMissions(MissionTable &missions, double budget);
+void loadMissions(MissionTable &missions, double &agencyBudget);
+void saveInventory(InventoryTable &inv);
+void loadInventory(InventoryTable &inv);
+void saveAstronauts(AstroTable &astros);
+void loadAstronauts(AstroTable &astros);
+void savePlanets(PlanetTable &planets);
+void loadPlanets(PlanetTable &planets);
+void saveExoplanets(ExoplanetTable &exos);
+void loadExoplanets(ExoplanetTable &exos);
+void loadLogs(LogStore &logs);
+void addLog(string action, LogStore &logs);
+// Binary snapshot (see snapshot.h)
+bool snapTable(const SnapshotFile &snap, string name, const Journal &j, uint32_t columns, SnapTable &t);
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<string> &out);
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<DictString> &out);
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<double> &out);
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<bool> &out);
+bool snapUsers(const SnapshotFile &snap, UserTable &users);
+bool snapHires(const SnapshotFile &snap, HireTable &hires);
+bool snapMissions(const SnapshotFile &snap, MissionTable &missions, double &agencyBudget);
+bool snapInventory(const SnapshotFile &snap, InventoryTable &inv);
+bool snapAstronauts(const SnapshotFile &snap, AstroTable &astros);
+bool snapPlanets(const SnapshotFile &snap, PlanetTable &planets);
+bool snapExoplanets(const SnapshotFile &snap, ExoplanetTable &exos);
+void saveSnapshot(Database &db);
 
 // Input Processors
 string getInput(string prompt);
+string cleanField(string s);
 int getInt(string prompt, int min, int max);
 double getDouble(string prompt, double min, double max);
 bool isValidUsername(string username);
@@ -171,106 +348,155 @@ bool isValidPassword(string password);
 int safeStoi(string s);
 double safeStod(string s);
 
+// Benchmarks
+void bench_Boot(int rows);
+void bench_Memory(int maxRows);
+void bench_Login(int maxRows);
+void bench_Delete(int maxRows);
+void bench_Render(int frames);
+void bench_Pager(int maxRows);
+void bench_Rollup(int rows);
+void bench_Launch(long long runs);
+void bench_Docking(int trajectories);
+void bench_Path(int size);
+size_t processMemory();
+
 // Main Function
-main()
+int main(int argc, char *argv[])
 {
-    // Variables Declaration and Initialization
-    //  User Data
-    string usernames[MAX_USERS], passwords[MAX_USERS], roles[MAX_USERS], departments[MAX_USERS];
-    int userCount = 0, currentUserIdx = -1;
-
-    // Hiring Data
-    string hireUsers[MAX_HIRES], hireRoles[MAX_HIRES], hireExp[MAX_HIRES], hireStatus[MAX_HIRES];
-    string hireNames[MAX_HIRES], hireEdu[MAX_HIRES];
-    int hireCount = 0;
-
-    // Mission Data
-    string missionNames[MAX_MISSIONS], missionCodes[MAX_MISSIONS], missionDates[MAX_MISSIONS];
-    string missionVehicles[MAX_MISSIONS], missionStatus[MAX_MISSIONS], missionRequesters[MAX_MISSIONS];
-    double missionBudgets[MAX_MISSIONS], missionCosts[MAX_MISSIONS];
-    int missionCount = 0;
-
-    // Agency Finance
-    double agencyBudget = 50.0; // Billions
-
-    // Inventory Data
-    string invNames[MAX_INVENTORY], invCats[MAX_INVENTORY], invUnits[MAX_INVENTORY];
-    double invQtys[MAX_INVENTORY], invCosts[MAX_INVENTORY];
-    int invCount = 0;
+    // --seed <n> in front of the other arguments replays a logged session
+    rngSeed = rng_NewSeed();
+    if (argc >= 3 && string(argv[1]) == "--seed")
+    {
+        rngSeed = strtoull(argv[2], nullptr, 10);
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    rng_Seed(rng, rngSeed);
 
-    // Astronaut Data
-    string astroNames[MAX_ASTRO], astroRanks[MAX_ASTRO], astroStatus[MAX_ASTRO];
-    int astroCount = 0;
+    // Command line tools, these run without the console interface
+    if (argc >= 2 && string(argv[1]) == "--bench")
+    {
+        string which = (argc >= 3 ? argv[2] : "");
+        if (which == "boot")
+            bench_Boot(argc >= 4 ? atoi(argv[3]) : 1000000);
+        else if (which == "memory")
+            bench_Memory(argc >= 4 ? atoi(argv[3]) : 10000000);
+        else if (which == "login")
+            bench_Login(argc >= 4 ? atoi(argv[3]) : 1000000);
+        else if (which == "delete")
+            bench_Delete(argc >= 4 ? atoi(argv[3]) : 1000000);
+        else if (which == "render")
+            bench_Render(argc >= 4 ? atoi(argv[3]) : 1000);
+        else if (which == "pager")
+            bench_Pager(argc >= 4 ? atoi(argv[3]) : 1000000);
+        else if (which == "rollup")
+            bench_Rollup(argc >= 4 ? atoi(argv[3]) : 10000000);
+        else if (which == "launch")
+            bench_Launch(argc >= 4 ? atoll(argv[3]) : 100000000);
+        else if (which == "docking")
+            bench_Docking(argc >= 4 ? atoi(argv[3]) : 4096);
+        else if (which == "path")
+            bench_Path(argc >= 4 ? atoi(argv[3]) : 4096);
+        else
+            cout << "Usage: nms --bench boot [rows]\n"
+                 << "       nms --bench memory [maxRows]\n"
+                 << "       nms --bench login [maxRows]\n"
+                 << "       nms --bench delete [maxRows]\n"
+                 << "       nms --bench render [frames]\n"
+                 << "       nms --bench pager [maxRows]\n"
+                 << "       nms --bench rollup [rows]\n"
+                 << "       nms --bench launch [runs]\n"
+                 << "       nms --bench docking [trajectories]\n"
+                 << "       nms --bench path [size]\n"
+                 << "Any mode may be preceded by --seed <n> to replay the random draws of a logged session\n";
+        return 0;
+    }
 
-    // Planet Data
-    string planetNames[MAX_PLANETS], planetTypes[MAX_PLANETS];
-    string planetAtms[MAX_PLANETS];
-    double planetDists[MAX_PLANETS], planetGravs[MAX_PLANETS];
-    int planetCount = 0;
+    // Script mode, runs the commands of a file (or stdin) without the console interface
+    if (argc >= 2 && string(argv[1]) == "--batch")
+    {
+        Database db;
+        LogStore logs;
+        vector<LoadTiming> timings;
+        init_Database(db, logs, timings);
+        addLog("RNG Seed: " + to_string(rngSeed), logs);
+        string path = (argc >= 3 ? argv[2] : "-");
+        if (path == "-")
+            return batch_Run(cin, db, logs) == 0 ? 0 : 1;
+        ifstream script(path);
+        if (!script)
+        {
+            cerr << "Cannot open " << path << "\n";
+            return 1;
+        }
+        return batch_Run(script, db, logs) == 0 ? 0 : 1;
+    }
 
-    // Exoplanet Data
-    string exoNames[MAX_PLANETS], exoTypes[MAX_PLANETS];
-    double exoDists[MAX_PLANETS];
-    bool exoHabitable[MAX_PLANETS];
-    int exoCount = 0;
+    // Variables Declaration and Initialization
+    //  Agency Data: users, hiring, missions, finance, inventory, astronauts, planets and exoplanets
+    Database db;
+    int currentUserIdx = -1;
 
     // Log Data
-    string logActions[MAX_LOGS];
-    int logCount = 0;
+    LogStore logs;
+
+    // Boot Report
+    vector<LoadTiming> timings;
 
     // --- INITIALIZATION ---
-    init_Database(usernames, passwords, roles, departments, userCount,
-                  hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount,
-                  missionNames, missionCodes, missionDates, missionVehicles, missionStatus, missionBudgets, missionRequesters, missionCosts, missionCount, agencyBudget,
-                  invNames, invCats, invQtys, invUnits, invCosts, invCount,
-                  astroNames, astroRanks, astroStatus, astroCount,
-                  planetNames, planetTypes, planetDists, planetGravs, planetAtms, planetCount,
-                  exoNames, exoDists, exoTypes, exoHabitable, exoCount,
-                  logActions, logCount);
+    init_Database(db, logs, timings);
 
     // Root Instructions
-    SetConsoleTitleA("NASA HORIZON - PROJECT TITAN");
+    term_Init();
+    term_SetTitle("NASA HORIZON - PROJECT TITAN");
+    frame_Init(console.frame, 100, 36);
     setCursor(false);
-    srand(time(0)); // Seed RNG
-    system("cls");
+    addLog("RNG Seed: " + to_string(rngSeed), logs);
+    clearScreen();
     cout << RD << "Please Wait! Initializing the Boot";
-    Sleep(500);
+    term_Sleep(500);
     cout << ".";
-    Sleep(700);
-    cout << ".";
-    Sleep(900);
+    term_Sleep(700);
     cout << ".";
+    term_Sleep(900);
+    cout << "." << RST << "\n\n";
+    // Shows how long each table took to come up
+    string report = "Boot:";
+    for (LoadTiming &t : timings)
+    {
+        cout << GRA << "   " << left << setw(12) << t.table << right << setw(9) << fixed << setprecision(2) << t.ms << " ms  " << (t.snapshot ? "snapshot" : "csv") << RST << "\n";
+        ostringstream part;
+        part << fixed << setprecision(2) << " " << t.table << " " << t.ms << "ms" << (t.snapshot ? "" : "(csv)");
+        report += part.str();
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    addLog(report, logs);
+    term_Sleep(800);
     drawLogo(true);
-    Sleep(500);
+    term_Sleep(500);
+
+    // Main menu interface
+    UiScreen mainMenu;
+    addLogo(mainMenu);
+    int boxX = 25;
+    int boxY = 12;
+    ui_Text(mainMenu, boxX, boxY + 1, "1. Sign In", FC_WHITE);
+    ui_Text(mainMenu, boxX, boxY + 2, "2. Sign Up", FC_WHITE);
+    ui_Text(mainMenu, boxX, boxY + 3, "3. History", FC_WHITE);
+    ui_Text(mainMenu, boxX, boxY + 4, "4. About", FC_WHITE);
+    ui_Text(mainMenu, boxX, boxY + 5, "5. Exit", FC_WHITE);
+    ui_Text(mainMenu, boxX - 3, boxY + 7, "Select Option: ", FC_YELLOW);
 
     // Main Menu
     while (true)
     {
-        // Main menu interface
-        drawLogo(false);
+        ui_Show(console, mainMenu, cout);
         clearKeyboardBuffer();
-        int boxX = 25;
-        int boxY = 12;
-
-        gotoxy(boxX, boxY + 1);
-        cout << WHT << "1. Sign In" << RST << endl;
-
-        gotoxy(boxX, boxY + 2);
-        cout << WHT << "2. Sign Up" << RST << endl;
-
-        gotoxy(boxX, boxY + 3);
-        cout << WHT << "3. History" << RST << endl;
-
-        gotoxy(boxX, boxY + 4);
-        cout << WHT << "4. About" << RST << endl;
 
-        gotoxy(boxX, boxY + 5);
-        cout << WHT << "5. Exit" << RST << endl;
-
-        gotoxy(boxX - 3, boxY + 7);
-        cout << YLW << "Select Option: " << RST;
-
-        char choice = _getch();
+        char choice = getKey();
         if (choice == '1')
         {
             int attempts = 0;
@@ -291,28 +517,21 @@ main()
                 gotoxy(20, 18);
                 string p = getInput("Password: ");
 
-                currentUserIdx = signIn(u, p, usernames, passwords, userCount, logActions, logCount);
+                currentUserIdx = signIn(u, p, db.users, logs);
 
                 gotoxy(18, 21);
                 // if successful  then give control to main dashboard
                 if (currentUserIdx != -1)
                 {
                     loginSuccess = true;
-                    addLog("Login Success: " + u, logActions, logCount);
+                    addLog("Login Success: " + u, logs);
                     animations(GRN + "Login Successful! Welcome " + u + RST, 15);
                     gotoxy(18, 22);
                     animations(GRN + "Let's Embark on the journey to explore universe" + RST, 10);
-                    Sleep(1500);
+                    term_Sleep(1500);
 
                     // Hand over Everything to Dashboard
-                    dashboard_Main(usernames, passwords, roles, userCount, currentUserIdx,
-                                   hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount,
-                                   missionNames, missionCodes, missionDates, missionVehicles, missionStatus, missionBudgets, missionRequesters, missionCosts, missionCount, agencyBudget,
-                                   invNames, invCats, invQtys, invUnits, invCosts, invCount,
-                                   astroNames, astroRanks, astroStatus, astroCount,
-                                   planetNames, planetTypes, planetDists, planetGravs, planetAtms, planetCount,
-                                   exoNames, exoDists, exoTypes, exoHabitable, exoCount,
-                                   logActions, logCount);
+                    dashboard_Main(db, currentUserIdx, logs);
                 }
                 // if login fails due to invalid credentials
                 else
@@ -326,21 +545,21 @@ main()
                         cout << YLW << "Attempts remaining: " << (3 - attempts) << RST;
                         gotoxy(18, 24);
                         cout << CYN << "Press any key to try again..." << RST;
-                        _getch();
+                        getKey();
                     }
                     else
                     {
                         gotoxy(18, 23);
                         cout << RD << "Maximum attempts exceeded!" << RST;
-                        Sleep(1000);
-                        system("cls");
+                        term_Sleep(1000);
+                        clearScreen();
                         drawLogo(false);
                         drawBox(15, 14, 70, 8);
                         gotoxy(28, 16);
                         cout << RD << "LOGIN FAILED!!! - MULTIPLE INVALID ATTEMPTS" << RST;
                         gotoxy(30, 18);
                         cout << YLW << "We are Suspicious you'r an Imposter. Returning to Main Menu..." << RST;
-                        Sleep(2000);
+                        term_Sleep(2000);
                     }
                 }
             }
@@ -376,7 +595,7 @@ main()
                 }
                 gotoxy(17, 20);
                 cout << RD << "Invalid Username! Follow the Instructions" << RST;
-                Sleep(900);
+                term_Sleep(900);
                 gotoxy(17, 20);
                 cout << "                                          ";
             }
@@ -400,18 +619,18 @@ main()
                 }
                 gotoxy(17, 25);
                 cout << RD << " Invalid Password! Follow the instructions" << RST;
-                Sleep(900);
+                term_Sleep(900);
                 gotoxy(17, 25);
                 cout << "                                                       ";
             }
             // If the credentials meets the requirement then sign up successful
-            if (signUp(u, p, usernames, passwords, roles, departments, userCount, logActions, logCount))
+            if (signUp(u, p, db.users, logs))
             {
                 gotoxy(18, 27);
                 animations(GRN + "Account Created Successfully!" + RST, 20);
                 gotoxy(18, 28);
                 animations(GRN + "Now you are part of this cosmic Family" + RST, 20);
-                Sleep(1500);
+                term_Sleep(1500);
             }
             // Other error and loop runs again
             else
@@ -421,8 +640,8 @@ main()
                 // We should ensure registerUser doesn't double print if we call it here.
                 // Based on previous code, registerUser prints "USERNAME TAKEN".
                 gotoxy(18, 27);
-                cout << RD << "Registration failed (Duplicate or Database is Full)!" << RST;
-                Sleep(1500);
+                cout << RD << "Registration failed (Username already taken)!" << RST;
+                term_Sleep(1500);
             }
         }
         // Modules for other options
@@ -431,120 +650,97 @@ main()
         else if (choice == '4')
             about();
         else if (choice == '5')
+        {
+            // Checkpoint everything so the next start only maps the snapshot
+            saveSnapshot(db);
             exit();
+        }
     }
 
     return 0;
 }
 
 // Functions definitions
-bool signUp(string username, string password, string usernames[], string passwords[], string roles[], string departments[], int &count, string logActions[], int &logCount)
+bool signUp(string username, string password, UserTable &users, LogStore &logs)
 {
+    Column<string> &usernames = users.col<UserName>();
     // Checks credentials format
     if (!isValidUsername(username) || !isValidPassword(password))
     {
         return false;
     }
-    // Checks if database is full
-    if (count >= MAX_USERS)
-    {
-        cout << "\n   " << RD << "Database is Full." << RST;
-        return false;
-    }
-
     // Checks for  already registered usernames
-    for (int i = 0; i < count; i++)
+    if (index_Find(userIndex, usernames, username) >= 0)
     {
-        if (usernames[i] == username)
-        {
-            cout << "\n   " << RD << "USERNAME TAKEN." << RST;
-            return false;
-        }
+        cout << "\n   " << RD << "USERNAME TAKEN." << RST;
+        return false;
     }
 
-    // If all checks all passed then passes the entered credentials to credential arrays to save
-    usernames[count] = username;
-    passwords[count] = password;
-    roles[count] = "visitor"; // New users will be visitors until apply for job and get hired
-    departments[count] = "GEN";
-    count++;
-    addLog("New Visitor Registered: " + username, logActions, logCount);
-    saveUsers(usernames, passwords, roles, departments, count);
+    // If all checks all passed then passes the entered credentials to a new row to save
+    int r = table_Append(users);
+    auto u = users[r];
+    u.get<UserName>() = username;
+    u.get<UserPassword>() = password;
+    u.get<UserRole>() = "visitor"; // New users will be visitors until apply for job and get hired
+    u.get<UserDept>() = "GEN";
+    index_Insert(userIndex, username, r);
+    journal_Touch(usersJournal, r);
+    addLog("New Visitor Registered: " + username, logs);
+    saveUsers(users);
     return true;
 }
 
-int signIn(string username, string password, string usernames[], string passwords[], int count, string logActions[], int &logCount)
+int signIn(string username, string password, UserTable &users, LogStore &logs)
 {
+    Column<string> &usernames = users.col<UserName>();
+    Column<string> &passwords = users.col<UserPassword>();
     // Default value is -1 in case if credentials are not found
-    int idx = -1;
-    for (int i = 0; i < count; i++)
-    {
-        // Checks if the entered credentials are present in the database
-        if (usernames[i] == username && passwords[i] == password)
-        {
-            idx = i;
-            break;
-        }
-    }
+    int idx = index_Find(userIndex, usernames, username);
+    if (idx >= 0 && (!table_Live(users, idx) || passwords[idx] != password))
+        idx = -1;
     return idx;
 }
 
 // Main dashboard after successfully logining in
-void dashboard_Main(string usernames[], string passwords[], string roles[], int userLimit, int &currentUserIdx,
-                    string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                    string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                    string invNames[], string invCats[], double invQtys[], string invUnits[], double invCosts[], int &invCount,
-                    string astroNames[], string astroRanks[], string astroStatus[], int &astroCount,
-                    string planetNames[], string planetTypes[], double planetDists[], double planetGravs[], string planetAtms[], int &planetCount,
-                    string exoNames[], double exoDists[], string exoTypes[], bool exoHabitable[], int &exoCount,
-                    string logActions[], int &logCount)
+void dashboard_Main(Database &db, int &currentUserIdx, LogStore &logs)
 {
+    Column<string> &usernames = db.users.col<UserName>();
+    Column<DictString> &roles = db.users.col<UserRole>();
+    // Dashboard Interface, built once, only the user's lines change between visits
+    static UiScreen screen;
+    static int userLine, roleLine, adminLine;
+    if (screen.widgets.empty())
+    {
+        int x = 25, y = 13;
+        addLogo(screen);
+        ui_Box(screen, 10, 10, 80, 18);
+        ui_Text(screen, 38, 11, "DASHBOARD", FC_BLUE);
+        userLine = ui_Text(screen, 60, 11, "");
+        roleLine = ui_Text(screen, 60, 12, "");
+        ui_Text(screen, x, y, "[1] FLIGHT OPS", FC_CYAN);
+        ui_Text(screen, x, y + 1, "[2] ENGINEERING", FC_GREEN);
+        ui_Text(screen, x, y + 2, "[3] SCIENCE", FC_MAGENTA);
+        ui_Text(screen, x, y + 3, "[4] HR", FC_BLUE);
+        ui_Text(screen, x, y + 4, "[5] ROVER OPS", FC_YELLOW);
+        ui_Text(screen, x, y + 5, "[6] CAREER CENTER", FC_WHITE);
+        ui_Text(screen, x, y + 6, "[7] QUERY", FC_WHITE);
+        adminLine = ui_Text(screen, x, y + 7, "");
+        ui_Text(screen, x, y + 9, "[0] LOGOUT");
+    }
     bool stay = true;
     while (stay)
     {
-        // Dashboard Interface
-        drawLogo(false);
-        drawBox(10, 10, 80, 18);
-        gotoxy(38, 11);
-        cout << BL << "DASHBOARD" << RST;
-        int x = 25, y = 13;
-
         // Displays user's information
-        gotoxy(60, 11);
-        cout << "User: " << usernames[currentUserIdx];
-        gotoxy(60, 12);
-        cout << "Role: " << roles[currentUserIdx];
-
-        gotoxy(x, y);
-        cout << CYN << "[1] FLIGHT OPS" << RST;
-        gotoxy(x, y + 1);
-        cout << GRN << "[2] ENGINEERING" << RST;
-        gotoxy(x, y + 2);
-        cout << MGD << "[3] SCIENCE" << RST;
-        gotoxy(x, y + 3);
-        cout << BL << "[4] HR" << RST;
-        gotoxy(x, y + 4);
-        cout << YLW << "[5] ROVER OPS" << RST;
-        gotoxy(x, y + 5);
-        cout << WHT << "[6] CAREER CENTER" << RST;
-
-        // In case user is admin, gives access to admin features
+        ui_Set(screen, userLine, "User: " + usernames[currentUserIdx].str());
+        ui_Set(screen, roleLine, "Role: " + roles[currentUserIdx].str());
+        // In case user is admin, gives access to admin features, otherwise it is locked for standard users
         if (roles[currentUserIdx] == "admin")
-        {
-            gotoxy(x, y + 7);
-            cout << RD << "[9] ADMIN PANEL" << RST;
-        }
-        // Otherwise it is locked for standard users
+            ui_Set(screen, adminLine, "[9] ADMIN PANEL", FC_RED);
         else
-        {
-            gotoxy(x, y + 7);
-            cout << GRA << "[Locked] Admin Only" << RST;
-        }
-
-        gotoxy(x, y + 9);
-        cout << "[0] LOGOUT";
+            ui_Set(screen, adminLine, "[Locked] Admin Only", FC_GRAY);
+        ui_Show(console, screen, cout);
         // Actions in case of choosing any option
-        char c = _getch();
+        char c = getKey();
         if (c == '1')
         {
             if (roles[currentUserIdx] == "visitor")
@@ -552,7 +748,7 @@ void dashboard_Main(string usernames[], string passwords[], string roles[], int
                 message("Restricted Area. Employees Only.");
             }
             else
-                dashboard_Flight(usernames, roles, currentUserIdx, missionNames, missionCodes, missionDates, missionVehicles, missionStatus, missionBudgets, missionRequesters, missionCosts, missionCount, agencyBudget, invNames, invCosts, invCount, logActions, logCount);
+                dashboard_Flight(db, currentUserIdx, logs);
         }
         else if (c == '2')
         {
@@ -561,11 +757,11 @@ void dashboard_Main(string usernames[], string passwords[], string roles[], int
                 message("Restricted Area. Engineering Access Required.");
             }
             else
-                dashboard_Eng(invNames, invCats, invQtys, invUnits, invCosts, invCount, logActions, logCount);
+                dashboard_Eng(db.inventory, logs);
         }
         else if (c == '3')
         {
-            dashboard_Science(planetNames, planetTypes, planetDists, planetGravs, planetAtms, planetCount, exoNames, exoDists, exoTypes, exoHabitable, exoCount, logActions, logCount);
+            dashboard_Science(db.planets, db.exoplanets, logs);
         }
         else if (c == '4')
         {
@@ -574,16 +770,19 @@ void dashboard_Main(string usernames[], string passwords[], string roles[], int
                 message("Restricted Area. Personnel Only.");
             }
             else
-                dashboard_HR(astroNames, astroRanks, astroStatus, astroCount);
+                dashboard_HR(db.astronauts);
         }
         else if (c == '5')
             ops_RoverGame();
         // Gives chance to standard to visitor to apply for job
         else if (c == '6')
-            career_Menu(usernames[currentUserIdx], roles[currentUserIdx], hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount, logActions, logCount);
+            career_Menu(usernames[currentUserIdx], roles[currentUserIdx], db.hires, logs);
+        // Filters and totals over the agency's tables
+        else if (c == '7')
+            dashboard_Query(db, currentUserIdx);
         // In case user is admin and presses admin option then passes it to admin module
         else if (c == '9' && roles[currentUserIdx] == "admin")
-            dashboard_Admin(usernames, passwords, roles, userLimit, hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount, missionNames, missionStatus, missionDates, missionBudgets, missionRequesters, missionCosts, missionCount, agencyBudget, astroNames, astroRanks, astroStatus, astroCount, logActions, logCount);
+            dashboard_Admin(db, currentUserIdx, logs);
         // In case if user wants to logout and goes back to main menu
         else if (c == '0')
         {
@@ -592,109 +791,181 @@ void dashboard_Main(string usernames[], string passwords[], string roles[], int
         }
     }
 }
+// Query console, runs a query typed in and pages through its result
+void dashboard_Query(Database &db, int currentUserIdx)
+{
+    Column<DictString> &roles = db.users.col<UserRole>();
+    while (true)
+    {
+        clearScreen();
+        cout << YLW << "   QUERY CONSOLE" << RST << "\n\n";
+        cout << queryTables(db) << "\n";
+        cout << "<table> [where <column> <op> <value> [and ...]] [by <column>]\n"
+             << "        [count] [sum|avg|min|max <column>[*<column>]] [order <column>|<aggregate> [desc]] [limit <n>]\n"
+             << "op: = != < <= > >= ~ (contains)\n\n"
+             << "e.g. inventory where category = Propulsion sum quantity*cost\n"
+             << "     missions by requester count sum cost order sum cost desc\n"
+             << "     exoplanets where habitable = 1 and distance < 50\n\n";
+        string line = getInput("Query (empty to go back): ");
+        vector<string> words = batch_Words(line);
+        if (words.empty())
+            return;
+        Query q;
+        QueryResult res;
+        string error;
+        if (!query_Parse(words, 0, q, error) || !runQuery(db, roles[currentUserIdx], q, res, error))
+        {
+            cout << RD << error << RST;
+            waitKey();
+            continue;
+        }
+        ostringstream title;
+        title << fixed << setprecision(3) << line << "  (" << res.matched << " of " << res.scanned << " rows, " << res.ms << " ms" << (res.sortCached ? ", cached sort" : "") << ")";
+        PagerView view;
+        view.title = title.str();
+        for (const string &h : res.header)
+            pager_Column(view, h, 30);
+        vector<string> cells;
+        pageTable(view, query_Count(res), [&](long long k, PagerRow &r)
+                  {
+                      query_Cells(res, k, cells);
+                      for (size_t c = 0; c < cells.size() && c < r.cells.size(); c++)
+                          r.cells[c] = cells[c]; },
+                  [](long long id)
+                  { return id - 1; });
+    }
+}
 
 // Internal Features
 
-void dashboard_Flight(string usernames[], string roles[], int currentUserIdx,
-                      string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                      string invNames[], double invCosts[], int invCount,
-                      string logActions[], int &logCount)
+void dashboard_Flight(Database &db, int currentUserIdx, LogStore &logs)
 {
+    Column<string> &usernames = db.users.col<UserName>();
+    Column<DictString> &roles = db.users.col<UserRole>();
     // Interface
+    static UiScreen screen;
+    if (screen.widgets.empty())
+        buildMenu(screen, "FLIGHT CONTROL", FC_CYAN, 13, {"[1] Manifest", "[2] Launch Sim", "[3] Docking", "[4] Request New Mission (Staff Only)", "[5] Delete Mission", "[6] My Missions", "[7] Back"});
     while (true)
     {
-        drawLogo(false);
-        drawBox(10, 11, 80, 13);
-        gotoxy(35, 12);
-        cout << CYN << "FLIGHT CONTROL" << RST;
-        gotoxy(20, 14);
-        cout << "[1] Manifest";
-        gotoxy(20, 15);
-        cout << "[2] Launch Sim";
-        gotoxy(20, 16);
-        cout << "[3] Docking";
-        gotoxy(20, 17);
-        cout << "[4] Request New Mission (Staff Only)";
-        gotoxy(20, 18);
-        cout << "[5] Delete Mission";
-        gotoxy(20, 19);
-        cout << "[6] Back";
-        char c = _getch();
+        ui_Show(console, screen, cout);
+        char c = getKey();
         // Options Conditions
         if (c == '1')
-            flight_Manifest(missionNames, missionCodes, missionDates, missionVehicles, missionStatus, missionRequesters, missionCount);
+            flight_Manifest(db.missions);
         if (c == '2')
-            sim_Launch(missionNames, missionVehicles, missionStatus, missionRequesters, missionCosts, missionCount, agencyBudget, logActions, logCount, missionDates);
+            sim_Launch(db.missions, db.agencyBudget, logs);
         if (c == '3')
             sim_Docking();
         if (c == '4')
         {
             if (roles[currentUserIdx] == "guest")
             {
-                system("cls");
+                clearScreen();
                 cout << RD << "Access Denied. Guests cannot plan missions." << RST;
-                pause();
+                waitKey();
             }
             else
-                flight_Request(usernames[currentUserIdx], missionNames, missionCodes, missionDates, missionVehicles, missionStatus, missionBudgets, missionRequesters, missionCosts, missionCount, invNames, invCosts, invCount, logActions, logCount);
+                flight_Request(usernames[currentUserIdx], db.missions, db.agencyBudget, db.inventory, logs);
         }
         if (c == '5')
-            flight_DeleteMission(missionNames, missionStatus, missionDates, missionRequesters, missionCosts, missionCount);
+            flight_DeleteMission(db.missions, db.agencyBudget);
         if (c == '6')
+            flight_MyMissions(usernames[currentUserIdx], db.missions);
+        if (c == '7')
             break;
     }
 }
 
 // Additional Flight Functions
 // For removing an mission
-void flight_DeleteMission(string names[], string status[], string dates[], string requesters[], double costs[], int &count)
+void flight_DeleteMission(MissionTable &missions, double agencyBudget)
 {
-    system("cls");
-    cout << "DELETE MISSION. Mission IDs(1-" << count << "): ";
-    int id = getInt("", 1, count);
+    clearScreen();
+    cout << "DELETE MISSION. Mission IDs(1-" << missions.size() << "): ";
+    int id = getInt("", 1, missions.size());
     int i = id - 1;
-    cout << "Deleting " << names[i] << "... ";
-    for (int k = i; k < count - 1; k++)
+    if (!table_Live(missions, i))
     {
-        names[k] = names[k + 1];
-        status[k] = status[k + 1];
-        dates[k] = dates[k + 1];
-        requesters[k] = requesters[k + 1];
-        costs[k] = costs[k + 1];
+        cout << RD << "No record with that ID." << RST;
+        waitKey();
+        return;
     }
-    count--;
+    cout << "Deleting " << missions.col<MissionName>()[i] << "... ";
+    flight_RemoveMission(missions, i);
+    saveMissions(missions, agencyBudget);
     cout << GRN << "Eliminated." << RST;
-    pause();
+    waitKey();
 }
 // For displaying the missions information
-void flight_Manifest(string names[], string codes[], string dates[], string vehicles[], string status[], string requesters[], int &count)
+void flight_Manifest(MissionTable &missions)
 {
-    system("cls");
-    cout << YLW << "   NASA MISSION MANIFEST DATABASE" << RST << endl;
-    cout << left << setw(4) << "ID" << setw(10) << "CODE" << setw(15) << "DATE" << setw(20) << "NAME" << setw(15) << "STATUS" << "REQUESTER\n";
-    cout << "------------------------------------------------------------------------------------\n";
-    for (int i = 0; i < count; i++)
+    Column<string> &names = missions.col<MissionName>();
+    Column<string> &codes = missions.col<MissionCode>();
+    Column<string> &dates = missions.col<MissionDate>();
+    Column<DictString> &status = missions.col<MissionStatus>();
+    Column<string> &requesters = missions.col<MissionRequester>();
+    static PagerView view;
+    if (view.columns.empty())
     {
-        if (names[i].empty())
-            continue;
-        string color = (status[i] == "Success" ? GRN : (status[i] == "Failure" ? RD : (status[i] == "Planned" ? CYN : YLW)));
-        cout << setw(4) << i + 1 << setw(10) << codes[i] << setw(15) << (dates ? dates[i] : "N/A") << setw(20) << names[i] << color << setw(15) << status[i] << RST << requesters[i] << endl;
+        view.title = "NASA MISSION MANIFEST DATABASE";
+        pager_Column(view, "ID", 8);
+        pager_Column(view, "CODE", 12);
+        pager_Column(view, "DATE", 10);
+        pager_Column(view, "NAME", 30);
+        pager_Column(view, "STATUS", 10);
+        pager_Column(view, "REQUESTER", 20);
     }
-    pause();
+    vector<int> rows;
+    for (int i = 0; i < missions.size(); i++)
+        if (table_Live(missions, i) && !names[i].empty())
+            rows.push_back(i);
+    pageTable(view, rows.size(), [&](long long p, PagerRow &r)
+              {
+                  int i = rows[p];
+                  uint8_t color = (status[i] == "Success" ? FC_GREEN : (status[i] == "Failure" ? FC_RED : (status[i] == "Planned" ? FC_CYAN : FC_YELLOW)));
+                  r.cells[0] = to_string(i + 1);
+                  r.cells[1] = codes[i];
+                  r.cells[2] = (dates[i].empty() ? string("N/A") : dates[i].str());
+                  r.cells[3] = names[i];
+                  r.cells[4] = status[i];
+                  r.colors[4] = color;
+                  r.cells[5] = requesters[i]; },
+              [&](long long id)
+              { return rowPosition(rows, id); });
+}
+// For displaying the missions requested by the current user
+void flight_MyMissions(string username, MissionTable &missions)
+{
+    clearScreen();
+    cout << YLW << "   MISSIONS REQUESTED BY " << username << RST << endl;
+    cout << left << setw(4) << "ID" << setw(10) << "CODE" << setw(15) << "DATE" << setw(20) << "NAME" << setw(15) << "STATUS" << "REQUESTER\n";
+    cout << "------------------------------------------------------------------------------------\n";
+    const vector<int> &rows = rowset_Rows(missionsByRequester, username);
+    for (int i : rows)
+        flight_ManifestRow(missions, i);
+    if (rows.empty())
+        cout << "   No missions requested yet.\n";
+    waitKey();
+}
+// One line of the manifest
+void flight_ManifestRow(MissionTable &missions, int i)
+{
+    Column<string> &names = missions.col<MissionName>();
+    Column<string> &codes = missions.col<MissionCode>();
+    Column<string> &dates = missions.col<MissionDate>();
+    Column<DictString> &status = missions.col<MissionStatus>();
+    Column<string> &requesters = missions.col<MissionRequester>();
+    if (!table_Live(missions, i) || names[i].empty())
+        return;
+    string color = (status[i] == "Success" ? GRN : (status[i] == "Failure" ? RD : (status[i] == "Planned" ? CYN : YLW)));
+    cout << setw(4) << i + 1 << setw(10) << codes[i] << setw(15) << (dates[i].empty() ? string("N/A") : dates[i].str()) << setw(20) << names[i] << color << setw(15) << status[i] << RST << requesters[i] << endl;
 }
 // For adding a new mission
-void flight_Request(string username, string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount,
-                    string invNames[], double invCosts[], int invCount, string logActions[], int &logCount)
+void flight_Request(string username, MissionTable &missions, double agencyBudget, InventoryTable &inv, LogStore &logs)
 {
-    system("cls");
+    clearScreen();
     cout << GRN << "   MISSION PLANNING PROTOCOL" << RST << endl;
-    if (missionCount >= MAX_MISSIONS)
-    {
-        cout << "Manifest Full.";
-        pause();
-        return;
-    }
-
     string name = getInput("   Mission Name (0 to Cancel): ");
     if (name == "0")
         return;
@@ -722,138 +993,233 @@ void flight_Request(string username, string missionNames[], string missionCodes[
             break;
     }
 
-    time_t now = time(0);
-    tm *ltm = localtime(&now);
-    char datStr[20];
-    strftime(datStr, 20, "%Y-%m-%d", ltm);
-
-    missionNames[missionCount] = name;
-    missionCodes[missionCount] = "REQ-" + to_string(missionCount + 100);
-    missionDates[missionCount] = string(datStr);
-    missionVehicles[missionCount] = vehicle;
-    missionStatus[missionCount] = "Pending";
-    missionBudgets[missionCount] = totalCost;
-    missionCosts[missionCount] = totalCost;
-    missionRequesters[missionCount] = username;
-    missionCount++;
-
-    addLog("Mission Requested: " + name, logActions, logCount);
+    flight_InsertMission(missions, username, name, vehicle, totalCost);
+    addLog("Mission Requested: " + name, logs);
+    saveMissions(missions, agencyBudget);
 
     cout << "\n   " << GRN << "MISSION REQUEST SUBMITTED." << RST << " Waiting for Admin Funding Approval.";
-    pause();
+    waitKey();
 }
 // Launching Simulation Prototype
-void sim_Launch(string names[], string vehicles[], string status[], string requesters[], double costs[], int &count, double agencyBudget, string logActions[], int &logCount, string dates[])
+void sim_Launch(MissionTable &missions, double agencyBudget, LogStore &logs)
 {
-    system("cls");
+    Column<string> &names = missions.col<MissionName>();
+    Column<DictString> &status = missions.col<MissionStatus>();
+    int count = missions.size();
+    clearScreen();
     // If no mission created
     if (count == 0)
     {
         cout << RD << "No missions available to launch. Create one first." << RST;
-        pause();
+        waitKey();
         return;
     }
     cout << "LAUNCH. ID(1-" << count << "): ";
     int id = getInt("", 1, count);
     int idx = id - 1;
+    if (!table_Live(missions, idx))
+    {
+        cout << RD << "No record with that ID." << RST;
+        waitKey();
+        return;
+    }
 
     if (status[idx] == "Pending")
     {
         cout << RD << "\n   ERROR: Mission not approved/funded by Admin yet." << RST;
-        pause();
+        waitKey();
         return;
     }
 
-    cout << "Launching " << names[idx] << "...\n";
-    Sleep(1000);
-    string sys[] = {"Fuel", "Guidance", "Comms", "Telemetry"};
-    for (string s : sys)
+    // Every launch gets a seed of its own, logged so the launch can be replayed with batch mode
+    uint64_t seed = rng_Next(rng);
+    Rng launch = rng_Make(seed);
+    cout << "Launching " << names[idx] << "..." << GRA << " (seed " << seed << ")" << RST << "\n";
+    term_Sleep(1000);
+    for (int s = 0; s < (int)launchFailure.size(); s++)
     {
-        cout << "   " << s << "... ";
-        Sleep(800);
-        if (rand() % 10 == 0) // 10% Failure Chance
+        cout << "   " << launchSystems[s] << "... ";
+        term_Sleep(800);
+        if (!sim_SystemGo(launch, s))
         {
             cout << RD << "FAIL" << RST << endl;
-            status[idx] = "Failure";
-            addLog("Launch Failure: " + names[idx], logActions, logCount);
-            saveMissions(count, names, status, requesters, costs, agencyBudget, dates);
+            flight_SetStatus(missions, idx, "Failure");
+            addLog("Launch Failure: " + names[idx] + " (seed " + to_string(seed) + ")", logs);
+            saveMissions(missions, agencyBudget);
 
             clearKeyboardBuffer();
             cout << "\n   " << RD << "MISSION ABORTED." << RST << endl;
             cout << "   " << YLW << "Press any key to return to Flight Control..." << RST;
-            _getch();
+            getKey();
             return;
         }
         cout << GRN << "GO" << RST << endl;
     }
     cout << "\n   " << GRN << "LIFTOFF! SUCCESSFUL ORBITAL INSERTION." << RST << endl;
-    status[idx] = "Success";
-    addLog("Launch Success: " + names[idx], logActions, logCount);
-    saveMissions(count, names, status, requesters, costs, agencyBudget, dates);
+    flight_SetStatus(missions, idx, "Success");
+    addLog("Launch Success: " + names[idx] + " (seed " + to_string(seed) + ")", logs);
+    saveMissions(missions, agencyBudget);
 
     clearKeyboardBuffer();
     cout << "\n   " << YLW << "Press any key to return..." << RST;
-    _getch();
+    getKey();
 }
 // Docking Simulation inspired by Interstellar
+// Clohessy-Wiltshire motion relative to the station (see docking.h). The flight runs on its
+// own clock, a fixed number of steps per second of real time, and keys are read without
+// waiting, so the chaser keeps drifting whether or not anything is pressed.
 void sim_Docking()
 {
-    system("cls");
-    cout << "DOCKING SIM (WASD). Goal: [+] to (O)\n";
-    int px = 0, py = 0, tx = 10, ty = 5, f = 20;
-    while (f > 0)
+    using namespace chrono;
+    const double fuelStart = 4.0, pulse = 0.05; // m/s of velocity change
+    const int warp = 50;                        // Seconds of flight per second on screen
+    const int scales[] = {1, 2, 5, 10, 20, 50, 100, 200};
+    static DockLanes lanes;
+    FrameBuffer fb;
+    frame_Init(fb, 60, 17);
+    setCursor(false);
+    clearKeyboardBuffer();
+
+    // Starts behind the station, somewhere above or below its orbit
+    DockState s;
+    s.x = (double)rng_Below(rng, 121) - 60;
+    s.y = -200.0 - rng_Below(rng, 201);
+    double fuel = fuelStart;
+    long long step = 0, planStart = -1; // Step the autopilot plan counts from, -1 when off
+    DockPlan plan;
+    string message = "Manual control", result;
+    auto t0 = steady_clock::now();
+    while (true)
     {
-        system("cls");
-        cout << "Fuel: " << f << endl;
+        while (result.empty() && term_KeyReady())
+        {
+            int c = tolower(getKey());
+            double dvx = (c == 'w' ? pulse : c == 's' ? -pulse : 0);
+            double dvy = (c == 'd' ? pulse : c == 'a' ? -pulse : 0);
+            if ((dvx != 0 || dvy != 0) && fuel >= pulse)
+            {
+                s.vx += dvx;
+                s.vy += dvy;
+                fuel -= pulse;
+                if (planStart >= 0)
+                    message = "Autopilot off, manual control";
+                planStart = -1;
+            }
+            else if (c == 'p')
+            {
+                plan = sim_PlanDocking(s, lanes);
+                char buf[120];
+                snprintf(buf, sizeof(buf), "Autopilot: %.2f m/s, best of %lld approaches (%.0f ms)", plan.fuel, plan.evaluated, plan.ms);
+                message = buf;
+                planStart = step;
+                if (!plan.found || plan.fuel > fuel)
+                {
+                    message = "Autopilot: no approach within the fuel left";
+                    planStart = -1;
+                }
+            }
+            else if (c == 'q')
+                result = "ABORTED";
+        }
+
+        // Steps due for the real time gone by, burns happen between steps as planned
+        long long due = (long long)(duration<double>(steady_clock::now() - t0).count() * warp / dockModel.dt);
+        while (result.empty() && step < due)
+        {
+            if (planStart >= 0 && step == planStart + plan.coast)
+            {
+                s.vx += plan.dv1x;
+                s.vy += plan.dv1y;
+                fuel -= hypot(plan.dv1x, plan.dv1y);
+            }
+            if (planStart >= 0 && step == planStart + plan.coast + plan.transfer)
+            {
+                s.vx += plan.dv2x;
+                s.vy += plan.dv2y;
+                fuel -= hypot(plan.dv2x, plan.dv2y);
+                planStart = -1;
+            }
+            double range = hypot(s.x, s.y), speed = hypot(s.vx, s.vy);
+            if (range < 1 && speed < 0.1)
+                result = "DOCKED";
+            else if (range < 1 && planStart < 0) // The autopilot brakes on arrival
+                result = "COLLISION";
+            else if (range > 2000)
+                result = "LOST CONTACT";
+            else if (fuel < pulse && planStart < 0 && speed > 0.1)
+                result = "OUT OF FUEL";
+            else
+            {
+                dock_Step(dockModel, s);
+                step++;
+            }
+        }
+
+        // Smallest scale that keeps the chaser on the grid, the station in the middle
+        int scale = scales[7];
+        for (int sc : scales)
+            if (fabs(s.y) <= 9.5 * sc && fabs(s.x) <= 4.5 * sc)
+            {
+                scale = sc;
+                break;
+            }
+        int cx = 10 + (int)lround(s.y / scale), cy = 5 - (int)lround(s.x / scale);
+        char line[120];
+        frame_Clear(fb);
+        frame_Text(fb, 0, 0, "DOCKING SIM (WASD thrust, P autopilot, Q abort). Goal: [+] to (O)");
+        snprintf(line, sizeof(line), "Range %.1f m  Speed %.2f m/s  Fuel %.2f m/s  T+%llds", hypot(s.x, s.y), hypot(s.vx, s.vy), max(0.0, fuel), (long long)(step * dockModel.dt));
+        frame_Text(fb, 0, 1, line);
         for (int y = 0; y < 10; y++)
         {
             for (int x = 0; x < 20; x++)
             {
-                if (x == px && y == py)
-                    cout << "[+]";
-                else if (x == tx && y == ty)
-                    cout << "(O)";
+                if (x == cx && y == cy)
+                    frame_Text(fb, x * 3, y + 2, "[+]", FC_CYAN);
+                else if (x == 10 && y == 5)
+                    frame_Text(fb, x * 3, y + 2, "(O)", FC_YELLOW);
                 else
-                    cout << " . ";
+                    frame_Text(fb, x * 3, y + 2, " . ");
             }
-            cout << endl;
-        }
-        if (px == tx && py == ty)
-        {
-            cout << GRN << "SUCCESS" << RST;
-            pause();
-            return;
         }
-        // For calibrating the docking controls
-        char c = _getch();
-        if (c == 'w' && py > 0)
-            py--;
-        if (c == 's' && py < 9)
-            py++;
-        if (c == 'a' && px > 0)
-            px--;
-        if (c == 'd' && px < 19)
-            px++;
-        f--;
+        snprintf(line, sizeof(line), "Radial %.1f m  Along-track %.1f m  %d m per cell", s.x, s.y, scale);
+        frame_Text(fb, 0, 12, line, FC_GRAY);
+        frame_Text(fb, 0, 13, message, planStart >= 0 ? FC_CYAN : FC_DEFAULT);
+        if (!result.empty())
+            frame_Text(fb, 0, 14, result, result == "DOCKED" ? FC_GREEN : FC_RED);
+        frame_Text(fb, 0, 16, frameStatus(fb.stats), FC_GRAY);
+        frame_Flush(fb, cout);
+        if (!result.empty())
+            break;
+        term_Sleep(50);
     }
-    cout << RD << "Failed" << RST;
-    pause();
+    gotoxy(0, 17);
+    setCursor(true);
+    clearKeyboardBuffer();
+    waitKey();
+}
+// Cheapest two-burn approach to the station from s, coasting up to 5 minutes first and
+// arriving 1 to 20 minutes after the first burn
+DockPlan sim_PlanDocking(const DockState &s, DockLanes &lanes)
+{
+    return dock_Plan(dockModel, s, 32, 128, 300, 60, 1200, lanes);
 }
 
 // Module to apply for a job
 
-void career_Menu(string username, string userRole, string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount, string logActions[], int &logCount)
+void career_Menu(string username, string userRole, HireTable &hires, LogStore &logs)
 {
+    Column<DictString> &hireRoles = hires.col<HireRole>();
+    Column<DictString> &hireStatus = hires.col<HireStatus>();
     while (true)
     {
-        system("cls");
+        clearScreen();
         cout << YLW << "   NASA CAREER CENTER" << RST << endl;
         cout << "   Current User: " << username << " (" << userRole << ")" << endl;
         cout << "\n   [1] Apply for Position";
         cout << "\n   [2] View Application Status";
         cout << "\n   [3] Back";
 
-        char c = _getch();
+        char c = getKey();
         if (c == '3')
             return;
         // In Case Admin tries to apply for a job. meri billi muji ko meow
@@ -862,24 +1228,18 @@ void career_Menu(string username, string userRole, string hireUsers[], string hi
             if (userRole == "admin")
             {
                 cout << "\n   " << RD << "Admins cannot apply for lower positions." << RST;
-                pause();
-                continue;
-            }
-            if (hireCount >= MAX_HIRES)
-            {
-                cout << "\n   Sorry, NASA is running low on resources so we cannot hire you as we can't pay you.";
-                pause();
+                waitKey();
                 continue;
             }
             // Ckecks if user already applied
             bool already = false;
-            for (int i = 0; i < hireCount; i++)
-                if (hireUsers[i] == username && hireStatus[i] == "Pending")
+            for (int i : rowset_Rows(hiresByUser, username))
+                if (hireStatus[i] == "Pending")
                     already = true;
             if (already)
             {
                 cout << "\n   You have a pending application.";
-                pause();
+                waitKey();
                 continue;
             }
             // If new candidate, prompts to fill the details
@@ -892,106 +1252,177 @@ void career_Menu(string username, string userRole, string hireUsers[], string hi
             int r = getInt("", 1, 3);
             string role = (r == 1 ? "astronaut" : (r == 2 ? "engineer" : "scientist"));
             // Stores the info
-            hireUsers[hireCount] = username;
-            hireRoles[hireCount] = role;
-            hireExp[hireCount] = exp;
-            hireNames[hireCount] = full;
-            hireEdu[hireCount] = edu;
-            hireStatus[hireCount] = "Pending";
-            hireCount++;
-            saveHires(hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount);
-            addLog("Applied: " + role, logActions, logCount);
+            int row = table_Append(hires);
+            auto h = hires[row];
+            h.get<HireUser>() = username;
+            h.get<HireRole>() = role;
+            h.get<HireExp>() = exp;
+            h.get<HireName>() = full;
+            h.get<HireEdu>() = edu;
+            h.get<HireStatus>() = "Pending";
+            rowset_Insert(hiresByUser, username, row);
+            rowset_Insert(hiresByStatus, "Pending", row);
+            journal_Touch(hiresJournal, row);
+            saveHires(hires);
+            addLog("Applied: " + role, logs);
             cout << GRN << "\n   Application Received." << RST;
-            pause();
+            waitKey();
         }
         // If the user already applied and wants to check the status
         if (c == '2')
         {
             cout << "\n\n   -- STATUS --\n";
             bool found = false;
-            for (int i = 0; i < hireCount; i++)
-            // Searches through stored data application submitted and what's the status
+            // Lists the applications this user submitted and what's their status
+            for (int i : rowset_Rows(hiresByUser, username))
             {
-                if (hireUsers[i] == username)
-                {
-                    cout << "   Role: " << hireRoles[i] << " | Status: " << (hireStatus[i] == "Approved" ? GRN : YLW) << hireStatus[i] << RST << endl;
-                    found = true;
-                }
+                cout << "   Role: " << hireRoles[i] << " | Status: " << (hireStatus[i] == "Approved" ? GRN : YLW) << hireStatus[i] << RST << endl;
+                found = true;
             }
             if (!found)
                 cout << "   No applications found.";
-            pause();
+            waitKey();
         }
     }
 }
 // Module if user is the admin
-void dashboard_Admin(string usernames[], string passwords[], string roles[], int &userCount,
-                     string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                     string missionNames[], string missionStatus[], string missionDates[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                     string astroNames[], string astroRanks[], string astroStatus[], int &astroCount,
-                     string logActions[], int &logCount)
+void dashboard_Admin(Database &db, int &currentUserIdx, LogStore &logs)
 {
+    static UiScreen screen;
+    static int spendLine;
+    if (screen.widgets.empty())
+    {
+        buildMenu(screen, "ADMINISTRATION", FC_RED, 13, {"[1] System Logs", "[2] Hiring Requests", "[3] Mission Funding Approvals", "[4] Personnel", "[5] Mission Spend", "[6] Back"});
+        spendLine = ui_Text(screen, 20, 21, "", FC_YELLOW);
+    }
     while (true)
     {
         // Admin Dashboard Interface
-        drawLogo(false);
-        drawBox(10, 11, 80, 13);
-        gotoxy(35, 12);
-        cout << RD << "ADMINISTRATION" << RST;
-        gotoxy(20, 14);
-        cout << "[1] System Logs";
-        gotoxy(20, 15);
-        cout << "[2] Hiring Requests";
-        gotoxy(20, 16);
-        cout << "[3] Mission Funding Approvals";
-        gotoxy(20, 17);
-        cout << "[4] Personnel";
-        gotoxy(20, 18);
-        cout << "[5] Back";
+        double committed, pending;
+        admin_SpendTotals(db.missions, committed, pending);
+        ui_Set(screen, spendLine, "Budget left $" + formatAmount(db.agencyBudget) + "B | Committed $" + formatAmount(committed) + "B | Awaiting funding $" + formatAmount(pending) + "B");
+        ui_Show(console, screen, cout);
         // Action on different choices
-        char c = _getch();
-        if (c == '5')
+        char c = getKey();
+        if (c == '6')
             break;
+        if (c == '5')
+            admin_Spend(db.missions, db.agencyBudget);
         if (c == '2')
-            admin_Hiring(usernames, roles, userCount, hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount, astroNames, astroRanks, astroStatus, astroCount, logActions, logCount);
+            admin_Hiring(db.users, db.hires, db.astronauts, logs);
         if (c == '4')
-            admin_Personnel(usernames, passwords, roles, nullptr, userCount, logActions, logCount);
+            admin_Personnel(db.users, currentUserIdx, logs);
         if (c == '3')
-            admin_Missions(missionNames, missionStatus, missionDates, missionBudgets, missionRequesters, missionCount, agencyBudget, logActions, logCount);
+            admin_Missions(db.missions, db.agencyBudget, logs);
         // Displays the activities that the users have done in this app
         if (c == '1')
-        {
-            system("cls");
-            cout << "SYSTEM LOGS\n";
-            for (int i = 0; i < logCount; i++)
-                cout << logActions[i] << endl;
-            pause();
-        }
+            admin_Logs(logs);
+    }
+}
+// Pages through the system logs, newest page first, reading only the records on screen
+void admin_Logs(LogStore &logs)
+{
+    static PagerView view;
+    if (view.columns.empty())
+    {
+        view.title = "SYSTEM LOGS";
+        pager_Column(view, "ENTRY", 10);
+        pager_Column(view, "ACTION", 86);
+    }
+    view.top = logs.total;
+    // Records are read a page at a time, the view asks for them in order
+    long long first = -1;
+    vector<string> page;
+    pageTable(view, logs.total, [&](long long p, PagerRow &r)
+              {
+                  if (first < 0 || p < first || p >= first + (long long)page.size())
+                  {
+                      first = p;
+                      log_Read(logs, first, view.height, page);
+                  }
+                  r.cells[0] = to_string(p + 1);
+                  if (p - first < (long long)page.size())
+                      r.cells[1] = page[p - first]; },
+              [](long long id)
+              { return id - 1; });
+}
+// Mission budgets per status, funded missions are committed spend
+void admin_Spend(MissionTable &missions, double agencyBudget)
+{
+    Column<DictString> &status = missions.col<MissionStatus>();
+    vector<RollupGroup> groups = rollup_GroupDot(status, missions.col<MissionBudget>(), nullptr);
+    groups[0].rows -= missions.deadRows;
+    double committed, pending;
+    admin_SpendTotals(missions, committed, pending);
+
+    vector<size_t> codes;
+    for (size_t k = 0; k < groups.size(); k++)
+        if (groups[k].rows > 0)
+            codes.push_back(k);
+    PagerView view;
+    view.title = "MISSION SPEND | Budget left $" + formatAmount(agencyBudget) + "B | Committed $" + formatAmount(committed) + "B | Awaiting funding $" + formatAmount(pending) + "B";
+    pager_Column(view, "STATUS", 12);
+    pager_Column(view, "MISSIONS", 10);
+    pager_Column(view, "BUDGET ($B)", 20);
+    pager_Column(view, "OF AGENCY FUNDS", 16);
+    double funds = agencyBudget + committed;
+    pageTable(view, codes.size(), [&](long long p, PagerRow &r)
+              {
+                  size_t k = codes[p];
+                  r.cells[0] = (k == 0 ? string("(none)") : status.dict.values[k]);
+                  r.cells[1] = to_string(groups[k].rows);
+                  r.cells[2] = formatAmount(groups[k].sum);
+                  r.cells[3] = formatAmount(funds > 0 ? 100.0 * groups[k].sum / funds : 0) + "%"; },
+              [](long long id)
+              { return id - 1; });
+}
+// Budgets of funded missions (committed) and of missions waiting for funds (pending)
+void admin_SpendTotals(MissionTable &missions, double &committed, double &pending)
+{
+    Column<DictString> &status = missions.col<MissionStatus>();
+    vector<RollupGroup> groups = rollup_GroupDot(status, missions.col<MissionBudget>(), nullptr);
+    committed = pending = 0;
+    for (size_t k = 1; k < groups.size(); k++)
+    {
+        if (status.dict.values[k] == "Pending")
+            pending += groups[k].sum;
+        else
+            committed += groups[k].sum;
     }
 }
 // Module to give admin access to all the personnels and users available in the agency
-void admin_Personnel(string usernames[], string passwords[], string roles[], string departments[], int &userCount, string logActions[], int &logCount)
+void admin_Personnel(UserTable &users, int &currentUserIdx, LogStore &logs)
 {
-    system("cls");
+    Column<string> &usernames = users.col<UserName>();
+    Column<DictString> &roles = users.col<UserRole>();
+    clearScreen();
     cout << "PERSONNEL DIRECTORY\n";
     // Creates a table to display the users and their roles going upto usercount
     cout << left << setw(5) << "ID" << setw(15) << "USER" << "ROLE\n";
-    for (int i = 0; i < userCount; i++)
-        cout << setw(5) << i + 1 << setw(15) << usernames[i] << roles[i] << endl;
+    for (int i = 0; i < users.size(); i++)
+        if (table_Live(users, i))
+            cout << setw(5) << i + 1 << setw(15) << usernames[i] << roles[i] << endl;
     // Editing options
     cout << "\n[E] Edit Role  [D] Delete User  [B] Back: ";
-    char c = _getch();
+    char c = getKey();
     if (c == 'b' || c == 'B')
         return;
-    int id = getInt("\nID: ", 1, userCount);
+    int id = getInt("\nID: ", 1, users.size());
     int i = id - 1;
+    if (!table_Live(users, i))
+    {
+        cout << RD << "No record with that ID." << RST;
+        waitKey();
+        return;
+    }
     // For editing the role of users
     if (c == 'e' || c == 'E')
     {
         cout << "New Role: ";
         roles[i] = getInput("");
-        addLog("Updated Role: " + usernames[i], logActions, logCount);
-        saveUsers(usernames, passwords, roles, departments, userCount);
+        journal_Touch(usersJournal, i);
+        addLog("Updated Role: " + usernames[i], logs);
+        saveUsers(users);
     }
     // For deleting users
     if (c == 'd' || c == 'D')
@@ -999,435 +1430,487 @@ void admin_Personnel(string usernames[], string passwords[], string roles[], str
         if (usernames[i] == "themystery")
         {
             cout << RD << "Cannot delete SuperAdmin." << RST;
-            pause();
+            waitKey();
             return;
         }
-        addLog("Deleted User: " + usernames[i], logActions, logCount);
-        for (int k = i; k < userCount - 1; k++)
-        {
-            usernames[k] = usernames[k + 1];
-            passwords[k] = passwords[k + 1];
-            roles[k] = roles[k + 1];
-            if (departments)
-                departments[k] = departments[k + 1];
-        }
-        userCount--;
-        saveUsers(usernames, passwords, roles, departments, userCount);
+        addLog("Deleted User: " + usernames[i], logs);
+        index_Remove(userIndex, usernames, i);
+        table_Kill(users, i);
+        journal_Touch(usersJournal, i);
+        compactTable(users, usersJournal);
+        saveUsers(users);
     }
-    pause();
+    waitKey();
 }
 // Module for approving missions and releasing funds
-void admin_Missions(string names[], string status[], string dates[], double budgets[], string requesters[], int &count, double &agencyBudget, string logActions[], int &logCount)
+void admin_Missions(MissionTable &missions, double &agencyBudget, LogStore &logs)
 {
-    system("cls");
+    Column<string> &names = missions.col<MissionName>();
+    Column<DictString> &status = missions.col<MissionStatus>();
+    Column<double> &budgets = missions.col<MissionBudget>();
+    // Every mission flies the same launch sequence, so one prediction serves them all
+    clearScreen();
+    if (launchForecast.runs != LAUNCH_PREDICT_RUNS || launchForecast.failure != launchFailure)
+    {
+        cout << GRA << "Simulating " << LAUNCH_PREDICT_RUNS << " launches..." << RST << flush;
+        launchForecast = {launchFailure, LAUNCH_PREDICT_RUNS, sim_Predict(LAUNCH_PREDICT_RUNS, rng_Next(rng))};
+        clearScreen();
+    }
+    const McLaunchResult &predicted = launchForecast.result;
     cout << "MISSION FUNDING | Agency Budget: $" << agencyBudget << "B\n";
+    cout << CYN << "Predicted launch success: " << sim_Percent(predicted.p) << " (95% CI " << sim_Percent(predicted.lo) << " - " << sim_Percent(predicted.hi) << ", " << predicted.runs << " simulated launches)\n";
+    cout << "Failures by subsystem:";
+    for (size_t s = 0; s < launchFailure.size(); s++)
+        cout << "  " << launchSystems[s] << " " << sim_Percent((double)predicted.failures[s] / max(1LL, predicted.runs - predicted.successes));
+    cout << RST << "\n\n";
     cout << left << setw(5) << "ID" << setw(20) << "NAME" << setw(10) << "COST" << "STATUS\n";
     // Displays those missions which are pending to be approved
-    for (int i = 0; i < count; i++)
-    {
-        if (status[i] == "Pending")
-        {
-            cout << setw(5) << i + 1 << setw(20) << names[i] << "$" << setw(9) << budgets[i] << status[i] << endl;
-        }
-    }
-    int id = getInt("\nApprove ID (0 to cancel): ", 0, count);
+    for (int i : rowset_Rows(missionsByStatus, "Pending"))
+        cout << setw(5) << i + 1 << setw(20) << names[i] << "$" << setw(9) << budgets[i] << status[i] << endl;
+    int id = getInt("\nApprove ID (0 to cancel): ", 0, missions.size());
     // To return back
     if (id == 0)
         return;
     // Takes input for which mission to be approved
     int i = id - 1;
-    if (agencyBudget >= budgets[i])
+    if (!table_Live(missions, i))
     {
-        agencyBudget -= budgets[i];
-        status[i] = "Planned";
-        addLog("Funded Mission: " + names[i], logActions, logCount);
-        saveMissions(count, names, status, requesters, budgets, agencyBudget, dates);
+        cout << RD << "No record with that ID." << RST;
+        waitKey();
+        return;
+    }
+    if (admin_FundMission(missions, agencyBudget, i))
+    {
+        addLog("Funded Mission: " + names[i], logs);
+        saveMissions(missions, agencyBudget);
     }
     else
         cout << RD << "Insufficient Funds." << RST;
-    pause();
+    waitKey();
 }
 // For approving job applications of candidates
-void admin_Hiring(string usernames[], string roles[], int userLimit, string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                  string astroNames[], string astroRanks[], string astroStatus[], int &astroCount, string logActions[], int &logCount)
+void admin_Hiring(UserTable &users, HireTable &hires, AstroTable &astros, LogStore &logs)
 {
-    system("cls");
+    Column<string> &hireUsers = hires.col<HireUser>();
+    Column<DictString> &hireRoles = hires.col<HireRole>();
+    Column<string> &hireExp = hires.col<HireExp>();
+    Column<string> &hireNames = hires.col<HireName>();
+    Column<string> &hireEdu = hires.col<HireEdu>();
+    clearScreen();
     cout << YLW << "   HIRING REQUESTS" << RST << endl;
     cout << left << setw(3) << "ID" << setw(10) << "USER" << setw(15) << "NAME" << setw(10) << "EDU" << setw(10) << "ROLE" << "EXP\n";
     // Displays those applications which are pending to be approved
-    for (int i = 0; i < hireCount; i++)
-    {
-        if (hireStatus[i] == "Pending")
-            cout << setw(3) << i + 1 << setw(10) << hireUsers[i] << setw(15) << hireNames[i] << setw(10) << hireEdu[i] << setw(10) << hireRoles[i] << hireExp[i] << endl;
-    }
+    for (int i : rowset_Rows(hiresByStatus, "Pending"))
+        cout << setw(3) << i + 1 << setw(10) << hireUsers[i] << setw(15) << hireNames[i] << setw(10) << hireEdu[i] << setw(10) << hireRoles[i] << hireExp[i] << endl;
     // Approve or reject
     cout << "\n   [A] Approve  [R] Reject  [B] Back\n";
-    char c = _getch();
+    char c = getKey();
     if (c == 'b' || c == 'B')
         return;
 
     if (c == 'a' || c == 'A')
     {
-        int id = getInt("   Enter ID: ", 1, hireCount);
+        int id = getInt("   Enter ID: ", 1, hires.size());
         int idx = id - 1;
-        // Checks if the applicant is present in the user database
-        bool found = false;
-        for (int k = 0; k < userLimit; k++)
-        {
-            if (usernames[k] == hireUsers[idx])
-            {
-                roles[k] = hireRoles[idx];
-                found = true;
-                break;
-            }
-        }
-
-        if (found)
+        // Only applicants present in the user database can be promoted
+        if (admin_ApproveHire(users, hires, astros, idx))
         {
-            hireStatus[idx] = "Approved";
-            addLog("Hired " + hireUsers[idx], logActions, logCount);
-            // If applicant register as an astronaut he is saved in that category
+            saveUsers(users);
+            addLog("Hired " + hireUsers[idx], logs);
             if (hireRoles[idx] == "astronaut")
             {
-                if (astroCount < MAX_ASTRO)
-                {
-                    astroNames[astroCount] = hireNames[idx];
-                    astroRanks[astroCount] = "Recruit";
-                    astroStatus[astroCount] = "Active";
-                    astroCount++;
-                    saveAstronauts(astroCount, astroNames, astroRanks, astroStatus);
-                    cout << GRN << "   [!] Added to Astronaut Roster." << RST;
-                }
-                else
-                {
-                    cout << RD << "   [!] Roster Full. Not added." << RST;
-                }
+                saveAstronauts(astros);
+                cout << GRN << "   [!] Added to Astronaut Roster." << RST;
             }
-            saveHires(hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount);
+            saveHires(hires);
             cout << GRN << "   Promoted." << RST;
         }
     }
     // If the admin wants to reject the application
     if (c == 'r' || c == 'R')
     {
-        int id = getInt("   Enter ID to REJECT: ", 1, hireCount);
-        int idx = id - 1;
-        hireStatus[idx] = "Rejected";
-        saveHires(hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount);
+        int id = getInt("   Enter ID to REJECT: ", 1, hires.size());
+        admin_RejectHire(hires, id - 1);
+        saveHires(hires);
         cout << RD << "   Application Rejected." << RST;
     }
-    pause();
+    waitKey();
 }
 // Module for engineers to check available inventory and build rovers
-void dashboard_Eng(string invNames[], string invCats[], double invQtys[], string invUnits[], double invCosts[], int &invCount, string logActions[], int &logCount)
+void dashboard_Eng(InventoryTable &inv, LogStore &logs)
 {
+    static UiScreen screen;
+    static int valueLine;
+    if (screen.widgets.empty())
+    {
+        buildMenu(screen, "ENG", FC_GREEN, 12, {"[1] Inventory", "[2] Rover Builder", "[3] Add Item", "[4] Delete Item", "[5] Valuation", "[6] Back"});
+        valueLine = ui_Text(screen, 20, 21, "", FC_GREEN);
+    }
     while (true)
     {
-        drawLogo(false);
-        drawBox(10, 11, 80, 12);
-        gotoxy(35, 12);
-        cout << GRN << "ENG" << RST;
-        gotoxy(20, 14);
-        cout << "[1] Inventory";
-        gotoxy(20, 15);
-        cout << "[2] Rover Builder";
-        gotoxy(20, 16);
-        cout << "[3] Add Item";
-        gotoxy(20, 17);
-        cout << "[4] Delete Item";
-        gotoxy(20, 18);
-        cout << "[5] Back";
-        char c = _getch();
+        double value = rollup_Dot(inv.col<InvQty>(), &inv.col<InvCost>());
+        ui_Set(screen, valueLine, "Stock value: $" + formatAmount(value) + "M in " + to_string(inv.size() - inv.deadRows) + " items");
+        ui_Show(console, screen, cout);
+        char c = getKey();
 
         if (c == '1')
-            eng_Inventory(invNames, invCats, invQtys, invCosts, invCount);
+            eng_Inventory(inv);
         if (c == '2')
-            eng_RoverBuilder(logActions, logCount);
+            eng_RoverBuilder(logs);
         if (c == '3')
-            eng_AddInventory(invNames, invCats, invQtys, invUnits, invCosts, invCount);
+            eng_AddInventory(inv);
         if (c == '4')
-            eng_DeleteInventory(invNames, invCats, invQtys, invUnits, invCosts, invCount);
+            eng_DeleteInventory(inv);
         if (c == '5')
+            eng_Valuation(inv);
+        if (c == '6')
             break;
     }
 }
 // Module to add newly designed invent
-void eng_AddInventory(string names[], string cats[], double qtys[], string units[], double costs[], int &count)
+void eng_AddInventory(InventoryTable &inv)
 {
-    if (count >= MAX_INVENTORY)
-    {
-        cout << "Database is Full. Press any key...";
-        _getch();
-        return;
-    }
-    system("cls");
+    clearScreen();
     cout << "ADD COMPONENT\n";
     // Adds component information to inventory
-    names[count] = getInput("Name: ");
-    cats[count] = getInput("Category (Propulsion/Structure/Power): ");
-    qtys[count] = getDouble("Quantity: ", 1, 10000);
-    units[count] = getInput("Unit (kg/box/pcs): ");
-    costs[count] = getDouble("Unit Cost ($M): ", 0.001, 100.0);
-    count++;
-    saveInventory(count, names, cats, qtys, units, costs);
+    string name = getInput("Name: ");
+    string cat = getInput("Category (Propulsion/Structure/Power): ");
+    double qty = getDouble("Quantity: ", 1, 10000);
+    string unit = getInput("Unit (kg/box/pcs): ");
+    double cost = getDouble("Unit Cost ($M): ", 0.001, 100.0);
+    eng_InsertItem(inv, name, cat, qty, unit, cost);
+    saveInventory(inv);
     cout << GRN << "Item Added. Press any key to return..." << RST;
-    _getch();
+    getKey();
 }
 // Module for deleting any outdated component in inventory
-void eng_DeleteInventory(string names[], string cats[], double qtys[], string units[], double costs[], int &count)
+void eng_DeleteInventory(InventoryTable &inv)
 {
-    system("cls");
-    cout << "DELETE COMPONENT. IDs(1-" << count << "): ";
+    clearScreen();
+    cout << "DELETE COMPONENT. IDs(1-" << inv.size() << "): ";
     // Gets the id of the component to delete
-    int id = getInt("", 1, count);
+    int id = getInt("", 1, inv.size());
     int i = id - 1;
-    cout << "Removing " << names[i] << "... ";
-    // Replaces the id of the component with the next one
-    for (int k = i; k < count - 1; k++)
-    {
-        names[k] = names[k + 1];
-        cats[k] = cats[k + 1];
-        qtys[k] = qtys[k + 1];
-        units[k] = units[k + 1];
-        costs[k] = costs[k + 1];
-    }
-    count--;
-    saveInventory(count, names, cats, qtys, units, costs);
+    if (!table_Live(inv, i))
+    {
+        cout << RD << "No record with that ID." << RST;
+        waitKey();
+        return;
+    }
+    cout << "Removing " << inv.col<InvName>()[i] << "... ";
+    eng_RemoveItem(inv, i);
+    saveInventory(inv);
     cout << GRN << "Updated. Press any key..." << RST;
-    _getch();
+    getKey();
+}
+// Stock value per category, totals computed by the rollup kernels (see rollup.h)
+void eng_Valuation(InventoryTable &inv)
+{
+    Column<DictString> &cats = inv.col<InvCat>();
+    auto started = chrono::steady_clock::now();
+    double total = rollup_Dot(inv.col<InvQty>(), &inv.col<InvCost>());
+    vector<RollupGroup> values = rollup_GroupDot(cats, inv.col<InvQty>(), &inv.col<InvCost>());
+    vector<RollupGroup> qtys = rollup_GroupDot(cats, inv.col<InvQty>(), nullptr);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    // Removed rows sit in code 0 with nothing to add
+    values[0].rows -= inv.deadRows;
+
+    vector<size_t> codes;
+    for (size_t k = 0; k < values.size(); k++)
+        if (values[k].rows > 0)
+            codes.push_back(k);
+    sort(codes.begin(), codes.end(), [&](size_t a, size_t b)
+         { return values[a].sum > values[b].sum; });
+
+    ostringstream title;
+    title << fixed << setprecision(3) << "INVENTORY VALUATION | Total $" << formatAmount(total) << "M | " << (rollup_HasAvx2() ? "AVX2" : "scalar") << " " << ms << " ms";
+    PagerView view;
+    view.title = title.str();
+    pager_Column(view, "CATEGORY", 20);
+    pager_Column(view, "ITEMS", 10);
+    pager_Column(view, "QUANTITY", 20);
+    pager_Column(view, "VALUE ($M)", 24);
+    pager_Column(view, "SHARE", 8);
+    pageTable(view, codes.size(), [&](long long p, PagerRow &r)
+              {
+                  size_t k = codes[p];
+                  r.cells[0] = (k == 0 ? string("(none)") : cats.dict.values[k]);
+                  r.cells[1] = to_string(values[k].rows);
+                  r.cells[2] = formatAmount(qtys[k].sum);
+                  r.cells[3] = formatAmount(values[k].sum);
+                  r.cells[4] = formatAmount(total > 0 ? 100.0 * values[k].sum / total : 0) + "%"; },
+              [](long long id)
+              { return id - 1; });
 }
 // Module for Cosmic Science knowledge
-void dashboard_Science(string planetNames[], string planetTypes[], double planetDists[], double planetGravs[], string planetAtms[], int &planetCount,
-                       string exoNames[], double exoDists[], string exoTypes[], bool exoHabitable[], int &exoCount,
-                       string logActions[], int &logCount)
+void dashboard_Science(PlanetTable &planets, ExoplanetTable &exos, LogStore &logs)
 {
+    static UiScreen screen;
+    if (screen.widgets.empty())
+        buildMenu(screen, "COSMIC SCIENCE", FC_MAGENTA, 13, {"[1] Planets", "[2] Exoplanets", "[3] Decrypt", "[4] Discover Planet", "[5] Discover Exoplanet", "[6] Delete Planet", "[7] Delete Exoplanet", "[8] Back"});
     while (true)
     {
         // Dashboard Interface
-        drawLogo(false);
-        drawBox(10, 11, 80, 13);
-        gotoxy(35, 12);
-        cout << MGD << "COSMIC SCIENCE" << RST;
-        gotoxy(20, 14);
-        cout << "[1] Planets";
-        gotoxy(20, 15);
-        cout << "[2] Exoplanets";
-        gotoxy(20, 16);
-        cout << "[3] Decrypt";
-        gotoxy(20, 17);
-        cout << "[4] Discover Planet";
-        gotoxy(20, 18);
-        cout << "[5] Discover Exoplanet";
-        gotoxy(20, 19);
-        cout << "[6] Delete Planet";
-        gotoxy(20, 20);
-        cout << "[7] Delete Exoplanet";
-        gotoxy(20, 21);
-        cout << "[8] Back";
-        char c = _getch();
+        ui_Show(console, screen, cout);
+        char c = getKey();
         // Option choices to go to different parts
 
         if (c == '1')
-            sci_Planets(planetNames, planetTypes, planetDists, planetGravs, planetAtms, planetCount);
+            sci_Planets(planets);
         if (c == '2')
-            sci_Exoplanets(exoNames, exoDists, exoTypes, exoHabitable, exoCount);
+            sci_Exoplanets(exos);
         if (c == '3')
-            sci_Decrypt(logActions, logCount);
+            sci_Decrypt(logs);
         if (c == '4')
-            sci_AddPlanet(planetNames, planetTypes, planetDists, planetGravs, planetAtms, planetCount);
+            sci_AddPlanet(planets);
         if (c == '5')
-            sci_AddExoplanet(exoNames, exoDists, exoTypes, exoHabitable, exoCount);
+            sci_AddExoplanet(exos);
         if (c == '6')
-            sci_DeletePlanet(planetNames, planetTypes, planetDists, planetGravs, planetAtms, planetCount);
+            sci_DeletePlanet(planets);
         if (c == '7')
-            sci_DeleteExoplanet(exoNames, exoDists, exoTypes, exoHabitable, exoCount);
+            sci_DeleteExoplanet(exos);
         if (c == '8')
             break;
     }
 }
 // Module for adding a new planet
-void sci_AddPlanet(string names[], string types[], double dists[], double gravs[], string atms[], int &count)
+void sci_AddPlanet(PlanetTable &planets)
 {
-    if (count >= MAX_PLANETS)
-    {
-        cout << "Database is Full.";
-        pause();
-        return;
-    }
-    system("cls");
+    clearScreen();
     cout << "DISCOVER NEW PLANET (0 to Cancel)\n";
-    names[count] = getInput("   What shall we name it?: ");
-    if (names[count] == "0")
+    string name = getInput("   What shall we name it?: ");
+    if (name == "0")
         return;
-    types[count] = getInput("   Planet Type (Rocky/Gas/Ice): ");
-    dists[count] = getDouble("   Distance from Sun (AU): ", 0.1, 100.0);
-    gravs[count] = getDouble("   Gravity (m/s2): ", 0.1, 100.0);
-    atms[count] = getInput("   Atmosphere Composition: ");
-    count++;
-    savePlanets(count, names, types, dists, gravs, atms);
+    string type = getInput("   Planet Type (Rocky/Gas/Ice): ");
+    double dist = getDouble("   Distance from Sun (AU): ", 0.1, 100.0);
+    double grav = getDouble("   Gravity (m/s2): ", 0.1, 100.0);
+    string atm = getInput("   Atmosphere Composition: ");
+    sci_InsertPlanet(planets, name, type, dist, grav, atm);
+    savePlanets(planets);
     cout << GRN << "Planet Cataloged." << RST;
-    pause();
+    waitKey();
 }
 // Module for adding any exoplanet
-void sci_AddExoplanet(string names[], double dists[], string types[], bool habitable[], int &count)
+void sci_AddExoplanet(ExoplanetTable &exos)
 {
-    if (count >= MAX_PLANETS)
-    {
-        cout << "Database is Full.";
-        pause();
-        return;
-    }
-    system("cls");
+    clearScreen();
     cout << "DISCOVER EXOPLANET\n";
-    names[count] = getInput("Name: ");
-    dists[count] = getDouble("Dist (Light Years): ", 1.0, 10000.0);
-    types[count] = getInput("Type: ");
+    string name = getInput("Name: ");
+    double dist = getDouble("Dist (Light Years): ", 1.0, 10000.0);
+    string type = getInput("Type: ");
     cout << "Habitable? (1=Yes, 0=No): ";
-    habitable[count] = (getInt("", 0, 1) == 1);
-    count++;
-    saveExoplanets(count, names, dists, types, habitable);
+    bool habitable = (getInt("", 0, 1) == 1);
+    sci_InsertExoplanet(exos, name, dist, type, habitable);
+    saveExoplanets(exos);
     cout << GRN << "Discovery Logged." << RST;
-    pause();
+    waitKey();
 }
 // Mofule for deleting a Planet
-void sci_DeletePlanet(string names[], string types[], double dists[], double gravs[], string atms[], int &count)
+void sci_DeletePlanet(PlanetTable &planets)
 {
-    system("cls");
-    cout << "DELETE PLANET. ID(1-" << count << "): ";
-    int id = getInt("", 1, count);
+    clearScreen();
+    cout << "DELETE PLANET. ID(1-" << planets.size() << "): ";
+    int id = getInt("", 1, planets.size());
     int i = id - 1;
-    cout << "Deleting " << names[i] << "... ";
-    for (int k = i; k < count - 1; k++)
+    if (!table_Live(planets, i))
     {
-        names[k] = names[k + 1];
-        types[k] = types[k + 1];
-        dists[k] = dists[k + 1];
-        gravs[k] = gravs[k + 1];
-        atms[k] = atms[k + 1];
+        cout << RD << "No record with that ID." << RST;
+        waitKey();
+        return;
     }
-    count--;
+    cout << "Deleting " << planets.col<PlanetName>()[i] << "... ";
+    sci_RemovePlanet(planets, i);
+    savePlanets(planets);
     cout << GRN << "Deleted." << RST;
-    pause();
+    waitKey();
 }
 // Module for deleting a exoplanet
-void sci_DeleteExoplanet(string names[], double dists[], string types[], bool habitable[], int &count)
+void sci_DeleteExoplanet(ExoplanetTable &exos)
 {
-    system("cls");
-    cout << "DELETE NOVELTY. ID(1-" << count << "): ";
-    int id = getInt("", 1, count);
+    clearScreen();
+    cout << "DELETE NOVELTY. ID(1-" << exos.size() << "): ";
+    int id = getInt("", 1, exos.size());
     int i = id - 1;
-    cout << "Deleting " << names[i] << "... ";
-    for (int k = i; k < count - 1; k++)
+    if (!table_Live(exos, i))
     {
-        names[k] = names[k + 1];
-        types[k] = types[k + 1];
-        dists[k] = dists[k + 1];
-        habitable[k] = habitable[k + 1];
+        cout << RD << "No record with that ID." << RST;
+        waitKey();
+        return;
     }
-    count--;
+    cout << "Deleting " << exos.col<ExoName>()[i] << "... ";
+    table_Kill(exos, i);
+    journal_Touch(exoJournal, i);
+    compactTable(exos, exoJournal);
+    saveExoplanets(exos);
     cout << GRN << "Deleted." << RST;
-    pause();
+    waitKey();
 }
 // Just a little fun activity for decrypting aliens message
-void sci_Decrypt(string logActions[], int &logCount)
+void sci_Decrypt(LogStore &logs)
 {
-    system("cls");
+    clearScreen();
     cout << "DECRYPT: 1, 1, 2, 3, 5... ";
     if (getInt("", 0, 100) == 8)
     {
         cout << GRN << "MATCH" << RST;
-        addLog("Decrypted", logActions, logCount);
+        addLog("Decrypted", logs);
     }
     else
         cout << RD << "FAIL" << RST;
-    pause();
+    waitKey();
 }
 // Moudle for HR to display the available staff for different missions
-void dashboard_HR(string astroNames[], string astroRanks[], string astroStatus[], int &astroCount)
+void dashboard_HR(AstroTable &astros)
 {
+    static UiScreen screen;
+    if (screen.widgets.empty())
+        buildMenu(screen, "HR", FC_BLUE, 12, {"[1] Roster", "[2] Training", "[3] Back"});
     while (true)
     {
-        drawLogo(false);
-        drawBox(10, 11, 80, 12);
-        gotoxy(35, 12);
-        cout << BL << "HR" << RST;
-        gotoxy(20, 14);
-        cout << "[1] Roster";
-        gotoxy(20, 15);
-        cout << "[2] Training";
-        gotoxy(20, 16);
-        cout << "[3] Back";
-        char c = _getch();
+        ui_Show(console, screen, cout);
+        char c = getKey();
         if (c == '3')
             break;
         if (c == '1')
-            hr_Roster(astroNames, astroRanks, astroStatus, astroCount);
+            hr_Roster(astros);
         if (c == '2')
             hr_Training();
     }
 }
 // For displaying the inventory of the agency
-void eng_Inventory(string names[], string cats[], double qtys[], double costs[], int &count)
+void eng_Inventory(InventoryTable &inv)
 {
-    system("cls");
-    cout << "INVENTORY\n";
-    cout << left << setw(5) << "ID" << setw(30) << "ITEM" << setw(12) << "CAT" << setw(8) << "QTY" << "COST\n";
-    cout << "--------------------------------------------------------------------\n";
-    for (int i = 0; i < 30 && i < count; i++)
+    Column<string> &names = inv.col<InvName>();
+    Column<DictString> &cats = inv.col<InvCat>();
+    Column<double> &qtys = inv.col<InvQty>();
+    Column<DictString> &units = inv.col<InvUnit>();
+    Column<double> &costs = inv.col<InvCost>();
+    static PagerView view;
+    if (view.columns.empty())
     {
-        cout << setw(5) << i + 1 << setw(30) << names[i] << setw(12) << cats[i] << setw(8) << qtys[i] << "$" << costs[i] << "\n";
+        view.title = "INVENTORY";
+        pager_Column(view, "ID", 8);
+        pager_Column(view, "ITEM", 30);
+        pager_Column(view, "CAT", 14);
+        pager_Column(view, "QTY", 10);
+        pager_Column(view, "UNIT", 6);
+        pager_Column(view, "COST", 10);
     }
-    pause();
+    vector<int> rows = liveRows(inv);
+    pageTable(view, rows.size(), [&](long long p, PagerRow &r)
+              {
+                  int i = rows[p];
+                  r.cells[0] = to_string(i + 1);
+                  r.cells[1] = names[i];
+                  r.cells[2] = cats[i];
+                  r.cells[3] = formatNumber(qtys[i]);
+                  r.cells[4] = units[i];
+                  r.cells[5] = "$" + formatNumber(costs[i]); },
+              [&](long long id)
+              { return rowPosition(rows, id); });
 }
 // Just for fun to build a rover that explores mars
-void eng_RoverBuilder(string logActions[], int &logCount)
+void eng_RoverBuilder(LogStore &logs)
 {
-    system("cls");
+    clearScreen();
     cout << "ROVER BUILDER. Name: ";
     string n = getInput("");
     cout << "   [O-O]\n  /_____\\\n  O-----O\n";
-    addLog("Built Rover: " + n, logActions, logCount);
-    pause();
+    addLog("Built Rover: " + n, logs);
+    waitKey();
 }
 // For displaying the planets with their details
-void sci_Planets(string names[], string types[], double dists[], double gravs[], string atms[], int &count)
+void sci_Planets(PlanetTable &planets)
 {
-    system("cls");
-    cout << "PLANETS\n";
-    cout << left << setw(20) << "NAME" << setw(15) << "TYPE" << setw(10) << "DISTANCE" << setw(10) << "GRAVITY" << "ATMOSPHERE\n";
-
-    for (int i = 0; i < count; i++)
+    Column<string> &names = planets.col<PlanetName>();
+    Column<DictString> &types = planets.col<PlanetType>();
+    Column<double> &dists = planets.col<PlanetDist>();
+    Column<double> &gravs = planets.col<PlanetGrav>();
+    Column<string> &atms = planets.col<PlanetAtm>();
+    static PagerView view;
+    if (view.columns.empty())
     {
-        cout << setw(20) << names[i] << setw(15) << types[i] << setw(10) << dists[i] << " AU" << setw(10) << gravs[i] << atms[i] << endl;
+        view.title = "PLANETS";
+        pager_Column(view, "ID", 8);
+        pager_Column(view, "NAME", 20);
+        pager_Column(view, "TYPE", 15);
+        pager_Column(view, "DISTANCE", 12);
+        pager_Column(view, "GRAVITY", 10);
+        pager_Column(view, "ATMOSPHERE", 30);
     }
-    pause();
+    vector<int> rows = liveRows(planets);
+    pageTable(view, rows.size(), [&](long long p, PagerRow &r)
+              {
+                  int i = rows[p];
+                  r.cells[0] = to_string(i + 1);
+                  r.cells[1] = names[i];
+                  r.cells[2] = types[i];
+                  r.cells[3] = formatNumber(dists[i]) + " AU";
+                  r.cells[4] = formatNumber(gravs[i]);
+                  r.cells[5] = atms[i]; },
+              [&](long long id)
+              { return rowPosition(rows, id); });
 }
 // For displaying the exoplanets with their details
-void sci_Exoplanets(string names[], double dists[], string types[], bool habitable[], int &count)
+void sci_Exoplanets(ExoplanetTable &exos)
 {
-    system("cls");
-    cout << "EXOPLANETS\n";
-    cout << left << setw(20) << "NAME" << setw(15) << "TYPE" << setw(10) << "DIST" << "HABITABLE\n";
-    for (int i = 0; i < count; i++)
+    Column<string> &names = exos.col<ExoName>();
+    Column<double> &dists = exos.col<ExoDist>();
+    Column<DictString> &types = exos.col<ExoType>();
+    Column<bool> &habitable = exos.col<ExoHabitable>();
+    static PagerView view;
+    if (view.columns.empty())
     {
-        cout << setw(20) << names[i] << setw(15) << types[i] << setw(10) << dists[i] << (habitable[i] ? (GRN + "YES" + RST) : (RD + "NO" + RST)) << endl;
+        view.title = "EXOPLANETS";
+        pager_Column(view, "ID", 8);
+        pager_Column(view, "NAME", 20);
+        pager_Column(view, "TYPE", 15);
+        pager_Column(view, "DIST", 10);
+        pager_Column(view, "HABITABLE", 9);
     }
-    pause();
+    vector<int> rows = liveRows(exos);
+    pageTable(view, rows.size(), [&](long long p, PagerRow &r)
+              {
+                  int i = rows[p];
+                  r.cells[0] = to_string(i + 1);
+                  r.cells[1] = names[i];
+                  r.cells[2] = types[i];
+                  r.cells[3] = formatNumber(dists[i]);
+                  r.cells[4] = (habitable[i] ? "YES" : "NO");
+                  r.colors[4] = (habitable[i] ? FC_GREEN : FC_RED); },
+              [&](long long id)
+              { return rowPosition(rows, id); });
 }
 // For displaying the personnel or rosters
-void hr_Roster(string names[], string ranks[], string status[], int &count)
+void hr_Roster(AstroTable &astros)
 {
-    system("cls");
-    cout << "PERSONNEL\n";
-    cout << left << setw(20) << "NAME" << setw(10) << "RANK" << "STATUS\n";
-    for (int i = 0; i < count; i++)
-        cout << setw(20) << names[i] << setw(10) << ranks[i] << status[i] << endl;
-    pause();
+    Column<string> &names = astros.col<AstroName>();
+    Column<DictString> &ranks = astros.col<AstroRank>();
+    Column<DictString> &status = astros.col<AstroStatus>();
+    static PagerView view;
+    if (view.columns.empty())
+    {
+        view.title = "PERSONNEL";
+        pager_Column(view, "ID", 8);
+        pager_Column(view, "NAME", 25);
+        pager_Column(view, "RANK", 12);
+        pager_Column(view, "STATUS", 12);
+    }
+    vector<int> rows = liveRows(astros);
+    pageTable(view, rows.size(), [&](long long p, PagerRow &r)
+              {
+                  int i = rows[p];
+                  r.cells[0] = to_string(i + 1);
+                  r.cells[1] = names[i];
+                  r.cells[2] = ranks[i];
+                  r.cells[3] = status[i]; },
+              [&](long long id)
+              { return rowPosition(rows, id); });
 }
 
 void hr_Training()
 {
-    system("cls");
+    clearScreen();
 
     cout << "Q1: Escape velocity of Earth (km/s)?\n";
     cout << "(1) 9.8   (2) 11.2   (3) 15.0 : ";
@@ -1484,97 +1967,251 @@ void hr_Training()
              << RST;
 
     cout << "\nHR Training Complete!";
-    pause();
+    waitKey();
 }
 
 // Rover Game for searching samples
+// The craters are kept in an occupancy grid (see pathfind.h), which the autopilot plans its
+// routes on. Manual driving moves one cell per key; with the autopilot on the rover follows
+// its route by itself, diagonals included, and any driving key takes back control.
 void ops_RoverGame()
 {
-    int rx = 2, ry = 2, sx = rand() % 20, sy = rand() % 15, score = 0;
-    int c1x = rand() % 18, c1y = rand() % 13;
-    int c2x = rand() % 20, c2y = rand() % 15; // Crater
+    const int width = 20, height = 15, craters = 30;
+    PathGrid grid;
+    PathSearch search;
+    PathResult route;
+    path_Init(grid, width, height);
+    for (int k = 0; k < craters; k++)
+        path_Set(grid, rng_Below(rng, width), rng_Below(rng, height), true);
+    int rx = 2, ry = 2, sx = 0, sy = 0, score = 0;
+    // The landing site is kept clear, so the rover can always reach a few cells
+    for (int y = ry - 1; y <= ry + 1; y++)
+        for (int x = rx - 1; x <= rx + 1; x++)
+            path_Set(grid, x, y, false);
+    // A sample is only dropped where the rover can reach it
+    auto placeSample = [&]()
+    {
+        vector<PathPoint> reach = path_Reachable(grid, {rx, ry});
+        PathPoint s = reach[1 + rng_Below(rng, (uint32_t)reach.size() - 1)];
+        sx = s.x;
+        sy = s.y;
+    };
+    placeSample();
+    bool autopilot = false;
+    vector<PathPoint> cells;
+    size_t next = 0;
+    string status = "P for autopilot";
+    auto plan = [&]()
+    {
+        auto t0 = chrono::steady_clock::now();
+        path_Jps(grid, {rx, ry}, {sx, sy}, search, route);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cells = path_Cells(route.points);
+        next = 1;
+        char buf[100];
+        snprintf(buf, sizeof(buf), "Autopilot: %d moves to sample, %lld nodes, %.3f ms", (int)cells.size() - 1, route.expanded, ms);
+        status = buf;
+    };
+
+    // The map is composed off screen and only the cells that changed are redrawn
+    FrameBuffer fb;
+    frame_Init(fb, 60, 21);
+    setCursor(false);
     while (true)
     {
-        system("cls");
-        cout << "ROVER OPS | Science: " << score << " | Q to Exit | WASD to Move\n";
-        cout << GRN << "S = Science Sample  " << RD << "X = Crater\n"
-             << RST;
-        for (int y = 0; y < 15; y++)
+        if (rx == sx && ry == sy)
         {
-            for (int x = 0; x < 20; x++)
+            score++;
+            placeSample();
+            if (autopilot)
+                plan();
+        }
+        bool crashed = !path_Free(grid, rx, ry);
+        frame_Clear(fb);
+        frame_Text(fb, 0, 0, "ROVER OPS | Science: " + to_string(score) + " | Q to Exit | WASD to Move | P Autopilot");
+        frame_Text(fb, 0, 1, "S = Science Sample  ", FC_GREEN);
+        frame_Text(fb, 20, 1, "X = Crater", FC_RED);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
             {
                 if (x == rx && y == ry)
-                    cout << "R ";
+                    frame_Put(fb, x * 2, y + 2, 'R', FC_CYAN);
                 else if (x == sx && y == sy)
-                    cout << "S ";
-                else if (x == c1x && y == c1y)
-                    cout << "X ";
-                else if (x == c2x && y == c2y)
-                    cout << "X ";
-
+                    frame_Put(fb, x * 2, y + 2, 'S', FC_GREEN);
+                else if (!path_Free(grid, x, y))
+                    frame_Put(fb, x * 2, y + 2, 'X', FC_RED);
                 else
-                    cout << ". ";
+                    frame_Put(fb, x * 2, y + 2, '.');
             }
-            cout << endl;
-        }
-        if (rx == sx && ry == sy)
+        if (autopilot)
+            for (size_t k = next; k + 1 < cells.size(); k++)
+                frame_Put(fb, cells[k].x * 2, cells[k].y + 2, '*', FC_GRAY);
+        frame_Text(fb, 0, 18, status, autopilot ? FC_CYAN : FC_GRAY);
+        if (crashed)
+            frame_Text(fb, 0, 19, "CRASHED INTO CRATER! MISSION TERMINATED.", FC_RED);
+        frame_Text(fb, 0, 20, frameStatus(fb.stats), FC_GRAY);
+        frame_Flush(fb, cout);
+        if (crashed)
         {
-            score++;
-            sx = rand() % 20;
-            sy = rand() % 15;
+            gotoxy(0, 21);
+            setCursor(true);
+            waitKey();
+            return;
         }
-        if (rx == c1x && ry == c1y || rx == c2x && ry == c2y)
+        // The autopilot drives on while no key is pressed
+        int c = 0;
+        if (!autopilot)
+            c = getKey();
+        else
         {
-            cout << RD << "\nCRASHED INTO CRATER! MISSION TERMINATED." << RST;
-            pause();
-            return;
+            term_Sleep(150);
+            if (term_KeyReady())
+                c = getKey();
         }
-        char c = _getch();
         if (c == 'q')
-            return;
+            break;
+        if (c == 'p')
+        {
+            autopilot = !autopilot;
+            if (autopilot)
+                plan();
+            else
+                status = "Manual control";
+            continue;
+        }
+        if (c == 'w' || c == 's' || c == 'a' || c == 'd')
+        {
+            autopilot = false;
+            status = "Manual control";
+        }
         if (c == 'w' && ry > 0)
             ry--;
-        if (c == 's' && ry < 14)
+        if (c == 's' && ry < height - 1)
             ry++;
         if (c == 'a' && rx > 0)
             rx--;
-        if (c == 'd' && rx < 19)
+        if (c == 'd' && rx < width - 1)
             rx++;
+        if (autopilot && next < cells.size())
+        {
+            rx = cells[next].x;
+            ry = cells[next].y;
+            next++;
+        }
     }
+    gotoxy(0, 21);
+    setCursor(true);
 }
 
 // initialize the core database of the agency
-void init_Database(string usernames[], string passwords[], string roles[], string departments[], int &userCount,
-                   string hireUsers[], string hireRoles[], string hireExp[], string hireStatus[], string hireNames[], string hireEdu[], int &hireCount,
-                   string missionNames[], string missionCodes[], string missionDates[], string missionVehicles[], string missionStatus[], double missionBudgets[], string missionRequesters[], double missionCosts[], int &missionCount, double &agencyBudget,
-                   string invNames[], string invCats[], double invQtys[], string invUnits[], double invCosts[], int &invCount,
-                   string astroNames[], string astroRanks[], string astroStatus[], int &astroCount,
-                   string planetNames[], string planetTypes[], double planetDists[], double planetGravs[], string planetAtms[], int &planetCount,
-                   string exoNames[], double exoDists[], string exoTypes[], bool exoHabitable[], int &exoCount,
-                   string logActions[], int &logCount)
-{
-    init_Users(usernames, passwords, roles, departments, userCount);
-    loadHires(hireUsers, hireRoles, hireExp, hireStatus, hireNames, hireEdu, hireCount);
-
-    init_Missions(missionNames, missionCodes, missionVehicles, missionStatus, missionBudgets, missionRequesters, missionCosts, missionCount, missionDates);
-    loadMissions(missionCount, missionNames, missionCodes, missionVehicles, missionStatus, missionBudgets, missionRequesters, missionCosts, agencyBudget, missionDates);
-
-    init_Inventory(invNames, invCats, invQtys, invUnits, invCosts, invCount);
-    loadInventory(invCount, invNames, invCats, invQtys, invUnits, invCosts);
-    init_Astronauts(astroNames, astroRanks, astroStatus, astroCount);
-    loadAstronauts(astroCount, astroNames, astroRanks, astroStatus);
-    init_Planets(planetNames, planetTypes, planetDists, planetGravs, planetAtms, planetCount);
-    loadPlanets(planetCount, planetNames, planetTypes, planetDists, planetGravs, planetAtms);
-    init_Exoplanets(exoNames, exoDists, exoTypes, exoHabitable, exoCount);
-    loadExoplanets(exoCount, exoNames, exoDists, exoTypes, exoHabitable);
-    loadLogs(logCount, logActions);
-}
-// Default users module
-void init_Users(string usernames[], string passwords[], string roles[], string departments[], int &count)
+void init_Database(Database &db, LogStore &logs, vector<LoadTiming> &timings)
 {
-    loadUsers(usernames, passwords, roles, departments, count);
-    if (count == 0)
-    {
+    // Tables whose snapshot copy is still current come straight out of the mapping,
+    // the others are parsed from their CSV files and the snapshot is refreshed afterwards.
+    // The tables are independent, so they load concurrently and are joined before the UI starts.
+    SnapshotFile snap;
+    snap_Open(snap, "nasa_snapshot.bin");
+    string names[] = {"users", "hires", "missions", "inventory", "astronauts", "planets", "exoplanets", "logs"};
+    bool fromSnap[8] = {false, false, false, false, false, false, false, false};
+    double ms[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    vector<function<void()>> tasks;
+    tasks.push_back([&]()
+                    {
+                        fromSnap[0] = snapUsers(snap, db.users);
+                        if (!fromSnap[0])
+                            init_Users(db.users);
+                        index_Build(userIndex, db.users.col<UserName>(), [&](int i)
+                                    { return table_Live(db.users, i); }); });
+    tasks.push_back([&]()
+                    {
+                        fromSnap[1] = snapHires(snap, db.hires);
+                        if (!fromSnap[1])
+                            loadHires(db.hires); });
+    tasks.push_back([&]()
+                    {
+                        fromSnap[2] = snapMissions(snap, db.missions, db.agencyBudget);
+                        if (!fromSnap[2])
+                        {
+                            init_Missions(db.missions);
+                            loadMissions(db.missions, db.agencyBudget);
+                        }
+                        auto live = [&](int i)
+                        { return table_Live(db.missions, i); };
+                        rowset_Build(missionsByStatus, db.missions.col<MissionStatus>(), live);
+                        rowset_Build(missionsByRequester, db.missions.col<MissionRequester>(), live); });
+    tasks.push_back([&]()
+                    {
+                        fromSnap[3] = snapInventory(snap, db.inventory);
+                        if (!fromSnap[3])
+                        {
+                            init_Inventory(db.inventory);
+                            loadInventory(db.inventory);
+                        } });
+    tasks.push_back([&]()
+                    {
+                        fromSnap[4] = snapAstronauts(snap, db.astronauts);
+                        if (!fromSnap[4])
+                        {
+                            init_Astronauts(db.astronauts);
+                            loadAstronauts(db.astronauts);
+                        } });
+    tasks.push_back([&]()
+                    {
+                        fromSnap[5] = snapPlanets(snap, db.planets);
+                        if (!fromSnap[5])
+                        {
+                            init_Planets(db.planets);
+                            loadPlanets(db.planets);
+                        } });
+    tasks.push_back([&]()
+                    {
+                        fromSnap[6] = snapExoplanets(snap, db.exoplanets);
+                        if (!fromSnap[6])
+                        {
+                            init_Exoplanets(db.exoplanets);
+                            loadExoplanets(db.exoplanets);
+                        } });
+    tasks.push_back([&]()
+                    { loadLogs(logs); fromSnap[7] = true; });
+
+    // Each task times itself so the report shows which table dominates
+    parallel_For((int)tasks.size(), parallel_Threads((int)tasks.size()), [&](int i)
+                 {
+                     auto start = chrono::steady_clock::now();
+                     tasks[i]();
+                     ms[i] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count(); });
+    snap_Close(snap);
+
+    // Rows the loaders could not read go to the audit log
+    Journal *journals[] = {&usersJournal, &hiresJournal, &missionsJournal, &invJournal, &astroJournal, &planetsJournal, &exoJournal};
+    for (Journal *j : journals)
+        for (CsvError &e : j->errors)
+            addLog("Load Error: " + e.file + " line " + to_string(e.line) + ": " + e.message + (e.text.empty() ? "" : ", kept in " + journal_RejectsPath(*j)), logs);
+
+    bool stale = false;
+    timings.clear();
+    for (int i = 0; i < 8; i++)
+    {
+        timings.push_back({names[i], ms[i], fromSnap[i] && i < 7});
+        if (!fromSnap[i])
+            stale = true;
+    }
+
+    if (stale)
+        saveSnapshot(db);
+}
+// Default users module
+void init_Users(UserTable &users)
+{
+    Column<string> &usernames = users.col<UserName>();
+    Column<string> &passwords = users.col<UserPassword>();
+    Column<DictString> &roles = users.col<UserRole>();
+    Column<string> &departments = users.col<UserDept>();
+    loadUsers(users);
+    if (users.size() == 0)
+    {
+        table_Resize(users, 3);
         usernames[0] = "themystery";
         passwords[0] = "29July1958";
         roles[0] = "admin";
@@ -1587,15 +2224,25 @@ void init_Users(string usernames[], string passwords[], string roles[], string d
         passwords[2] = "engineer1";
         roles[2] = "staff";
         departments[2] = "ENG";
-        count = 3;
-        saveUsers(usernames, passwords, roles, departments, count);
+        for (int i = 0; i < users.size(); i++)
+            journal_Touch(usersJournal, i);
+        saveUsers(users);
     }
 }
 // Default missions module
-void init_Missions(string names[], string codes[], string vehicles[], string status[], double budgets[], string requesters[], double costs[], int &count, string dates[])
+void init_Missions(MissionTable &missions)
 {
-    if (count > 0)
+    Column<string> &names = missions.col<MissionName>();
+    Column<string> &codes = missions.col<MissionCode>();
+    Column<string> &vehicles = missions.col<MissionVehicle>();
+    Column<DictString> &status = missions.col<MissionStatus>();
+    Column<double> &budgets = missions.col<MissionBudget>();
+    Column<string> &requesters = missions.col<MissionRequester>();
+    Column<double> &costs = missions.col<MissionCost>();
+    Column<string> &dates = missions.col<MissionDate>();
+    if (missions.size() > 0)
         return; // Don't re-init
+    table_Resize(missions, 3);
     // Mercury
     names[0] = "Freedom 7";
     codes[0] = "MR-3";
@@ -1621,13 +2268,17 @@ void init_Missions(string names[], string codes[], string vehicles[], string sta
     requesters[2] = "History";
     costs[2] = 0.2;
     dates[2] = "1962-02-20";
-    count = 3;
 }
 // Default inventory module
-void init_Inventory(string names[], string cats[], double qtys[], string units[], double costs[], int &count)
+void init_Inventory(InventoryTable &inv)
 {
-    if (count > 0)
+    Column<string> &names = inv.col<InvName>();
+    Column<DictString> &cats = inv.col<InvCat>();
+    Column<double> &qtys = inv.col<InvQty>();
+    Column<double> &costs = inv.col<InvCost>();
+    if (inv.size() > 0)
         return;
+    table_Resize(inv, 15);
     names[0] = "Hydrazine Fuel";
     cats[0] = "Propulsion";
     qtys[0] = 5000;
@@ -1688,11 +2339,14 @@ void init_Inventory(string names[], string cats[], double qtys[], string units[]
     cats[14] = "Science";
     qtys[14] = 200;
     costs[14] = 0.05;
-    count = 15;
 }
 // Defualt Astronauts
-void init_Astronauts(string names[], string ranks[], string status[], int &count)
+void init_Astronauts(AstroTable &astros)
 {
+    Column<string> &names = astros.col<AstroName>();
+    Column<DictString> &ranks = astros.col<AstroRank>();
+    Column<DictString> &status = astros.col<AstroStatus>();
+    table_Resize(astros, 9);
     names[0] = "Neil Armstrong";
     ranks[0] = "Commander";
     status[0] = "Retired";
@@ -1721,11 +2375,16 @@ void init_Astronauts(string names[], string ranks[], string status[], int &count
     ranks[8] = "Specialist";
     status[8] = "Active";
 
-    count = 9; // Only real astronauts
 }
 // Solar system Planets
-void init_Planets(string names[], string types[], double dists[], double gravs[], string atms[], int &count)
+void init_Planets(PlanetTable &planets)
 {
+    Column<string> &names = planets.col<PlanetName>();
+    Column<DictString> &types = planets.col<PlanetType>();
+    Column<double> &dists = planets.col<PlanetDist>();
+    Column<double> &gravs = planets.col<PlanetGrav>();
+    Column<string> &atms = planets.col<PlanetAtm>();
+    table_Resize(planets, 8);
     names[0] = "Mercury";
     types[0] = "Rocky";
     dists[0] = 0.39;
@@ -1766,11 +2425,15 @@ void init_Planets(string names[], string types[], double dists[], double gravs[]
     dists[7] = 30.0;
     gravs[7] = 11.15;
     atms[7] = "H/He/CH4";
-    count = 8;
 }
 // outer terestial palanets
-void init_Exoplanets(string names[], double dists[], string types[], bool habitable[], int &count)
+void init_Exoplanets(ExoplanetTable &exos)
 {
+    Column<string> &names = exos.col<ExoName>();
+    Column<double> &dists = exos.col<ExoDist>();
+    Column<DictString> &types = exos.col<ExoType>();
+    Column<bool> &habitable = exos.col<ExoHabitable>();
+    table_Resize(exos, 5);
     names[0] = "Proxima Centauri b";
     dists[0] = 4.2;
     habitable[0] = true;
@@ -1791,353 +2454,647 @@ void init_Exoplanets(string names[], double dists[], string types[], bool habita
     dists[4] = 150.0;
     habitable[4] = false;
     types[4] = "Hot Jupiter";
-    count = 5;
 }
 
-// Module for saving users
-void saveUsers(string usernames[], string passwords[], string roles[], string departments[], int count)
+// Record operations
+// These change the tables, their indexes and journals; saving is left to the caller so batch
+// mode can write everything out once
+// For the code of a new mission request, above every REQ- code still in the table
+string flight_NextRequestCode(const MissionTable &missions)
 {
-    ofstream f("nasa_users.csv");
-    if (f.is_open())
+    const Column<string> &codes = missions.col<MissionCode>();
+    for (int i = 0; i < missions.size(); i++)
     {
-        f << count << endl;
-        for (int i = 0; i < count; i++)
-            f << usernames[i] << "," << passwords[i] << "," << roles[i] << "," << departments[i] << endl;
+        string_view code = codes[i];
+        if (table_Live(missions, i) && code.substr(0, 4) == "REQ-")
+            nextRequestCode = max(nextRequestCode, atoi(string(code.substr(4)).c_str()) + 1);
     }
+    return "REQ-" + to_string(nextRequestCode++);
+}
+int flight_InsertMission(MissionTable &missions, string username, string name, string vehicle, double cost)
+{
+    time_t now = time(0);
+    tm *ltm = localtime(&now);
+    char datStr[20];
+    strftime(datStr, 20, "%Y-%m-%d", ltm);
+
+    string code = flight_NextRequestCode(missions);
+    int r = table_Append(missions);
+    auto m = missions[r];
+    m.get<MissionName>() = name;
+    m.get<MissionCode>() = code;
+    m.get<MissionDate>() = string(datStr);
+    m.get<MissionVehicle>() = vehicle;
+    m.get<MissionStatus>() = "Pending";
+    m.get<MissionBudget>() = cost;
+    m.get<MissionCost>() = cost;
+    m.get<MissionRequester>() = username;
+    rowset_Insert(missionsByStatus, "Pending", r);
+    rowset_Insert(missionsByRequester, username, r);
+    journal_Touch(missionsJournal, r);
+    return r;
+}
+void flight_SetStatus(MissionTable &missions, int i, string status)
+{
+    Column<DictString> &statuses = missions.col<MissionStatus>();
+    rowset_Move(missionsByStatus, statuses[i], status, i);
+    statuses[i] = status;
+    journal_Touch(missionsJournal, i);
+}
+void flight_RemoveMission(MissionTable &missions, int i)
+{
+    Column<DictString> &status = missions.col<MissionStatus>();
+    Column<string> &requesters = missions.col<MissionRequester>();
+    rowset_Remove(missionsByStatus, status[i], i);
+    rowset_Remove(missionsByRequester, requesters[i], i);
+    table_Kill(missions, i);
+    journal_Touch(missionsJournal, i);
+    compactTable(missions, missionsJournal);
+}
+// One subsystem check of a launch, see launchFailure
+bool sim_SystemGo(Rng &r, int system)
+{
+    return !rng_Chance(r, launchFailure[system]);
+}
+// Success rate of the launch sequence over runs simulated launches (see montecarlo.h)
+McLaunchResult sim_Predict(long long runs, uint64_t seed)
+{
+    return mc_Launch(launchFailure, runs, seed, parallel_Threads(1 << 30, 64));
+}
+string sim_Percent(double p)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.2f%%", p * 100);
+    return buf;
+}
+// Funds a mission out of the agency budget, false when the budget does not cover it
+bool admin_FundMission(MissionTable &missions, double &agencyBudget, int i)
+{
+    Column<double> &budgets = missions.col<MissionBudget>();
+    if (agencyBudget < budgets[i])
+        return false;
+    agencyBudget -= budgets[i];
+    flight_SetStatus(missions, i, "Planned");
+    return true;
+}
+// Gives the applicant the role applied for, false when the applicant has no account
+bool admin_ApproveHire(UserTable &users, HireTable &hires, AstroTable &astros, int idx)
+{
+    Column<string> &usernames = users.col<UserName>();
+    Column<DictString> &roles = users.col<UserRole>();
+    Column<string> &hireUsers = hires.col<HireUser>();
+    Column<DictString> &hireRoles = hires.col<HireRole>();
+    Column<DictString> &hireStatus = hires.col<HireStatus>();
+    int k = index_Find(userIndex, usernames, hireUsers[idx]);
+    if (k < 0)
+        return false;
+    roles[k] = hireRoles[idx];
+    journal_Touch(usersJournal, k);
+    rowset_Move(hiresByStatus, hireStatus[idx], "Approved", idx);
+    hireStatus[idx] = "Approved";
+    journal_Touch(hiresJournal, idx);
+    // If applicant register as an astronaut he is saved in that category
+    if (hireRoles[idx] == "astronaut")
+        hr_InsertAstronaut(astros, hires.col<HireName>()[idx], "Recruit", "Active");
+    return true;
+}
+void admin_RejectHire(HireTable &hires, int idx)
+{
+    Column<DictString> &hireStatus = hires.col<HireStatus>();
+    rowset_Move(hiresByStatus, hireStatus[idx], "Rejected", idx);
+    hireStatus[idx] = "Rejected";
+    journal_Touch(hiresJournal, idx);
+}
+int eng_InsertItem(InventoryTable &inv, string name, string cat, double qty, string unit, double cost)
+{
+    int r = table_Append(inv);
+    auto item = inv[r];
+    item.get<InvName>() = name;
+    item.get<InvCat>() = cat;
+    item.get<InvQty>() = qty;
+    item.get<InvUnit>() = unit;
+    item.get<InvCost>() = cost;
+    journal_Touch(invJournal, r);
+    return r;
+}
+void eng_RemoveItem(InventoryTable &inv, int i)
+{
+    table_Kill(inv, i);
+    journal_Touch(invJournal, i);
+    compactTable(inv, invJournal);
+}
+int sci_InsertPlanet(PlanetTable &planets, string name, string type, double dist, double grav, string atm)
+{
+    int r = table_Append(planets);
+    auto p = planets[r];
+    p.get<PlanetName>() = name;
+    p.get<PlanetType>() = type;
+    p.get<PlanetDist>() = dist;
+    p.get<PlanetGrav>() = grav;
+    p.get<PlanetAtm>() = atm;
+    journal_Touch(planetsJournal, r);
+    return r;
+}
+void sci_RemovePlanet(PlanetTable &planets, int i)
+{
+    table_Kill(planets, i);
+    journal_Touch(planetsJournal, i);
+    compactTable(planets, planetsJournal);
+}
+int hr_InsertAstronaut(AstroTable &astros, string name, string rank, string status)
+{
+    int r = table_Append(astros);
+    auto a = astros[r];
+    a.get<AstroName>() = name;
+    a.get<AstroRank>() = rank;
+    a.get<AstroStatus>() = status;
+    journal_Touch(astroJournal, r);
+    return r;
+}
+int sci_InsertExoplanet(ExoplanetTable &exos, string name, double dist, string type, bool habitable)
+{
+    int r = table_Append(exos);
+    auto e = exos[r];
+    e.get<ExoName>() = name;
+    e.get<ExoDist>() = dist;
+    e.get<ExoType>() = type;
+    e.get<ExoHabitable>() = habitable;
+    journal_Touch(exoJournal, r);
+    return r;
+}
+
+// Trims dead rows off the end of a table (see table_Compact) and records them in the table's
+// journal as deleted
+template <class T>
+void compactTable(T &t, Journal &j)
+{
+    int before = t.size();
+    table_Compact(t);
+    for (int r = before - 1; r >= t.size(); r--)
+        journal_Delete(j, r);
+}
+// Module for saving users
+// Only the rows marked in usersJournal are written, see journal.h
+void saveUsers(UserTable &users)
+{
+    Column<string> &usernames = users.col<UserName>();
+    Column<string> &passwords = users.col<UserPassword>();
+    Column<DictString> &roles = users.col<UserRole>();
+    Column<string> &departments = users.col<UserDept>();
+    journal_Save(usersJournal, to_string(users.size()), users.size(), [&](int i)
+                 {
+                     if (!table_Live(users, i))
+                         return string();
+                     return usernames[i] + "," + passwords[i] + "," + roles[i] + "," + departments[i]; });
 }
 // Module for loading the users in the file
-void loadUsers(string usernames[], string passwords[], string roles[], string departments[], int &count)
+void loadUsers(UserTable &users)
 {
-    ifstream f("nasa_users.csv");
-    if (f.is_open())
+    CsvData data;
+    if (journal_Load(usersJournal, data))
     {
-        int cnt;
-        f >> cnt;
-        if (cnt > MAX_USERS)
-            cnt = MAX_USERS;
-        count = 0;
-        string line;
-        f.ignore(1000, '\n');
-        for (int i = 0; i < cnt && i < MAX_USERS; i++)
-        {
-            if (getline(f, line))
-            {
-                size_t p1 = line.find(',');
-                size_t p2 = line.find(',', p1 + 1);
-                size_t p3 = line.find(',', p2 + 1);
-                if (p3 != string::npos)
-                {
-                    usernames[i] = line.substr(0, p1);
-                    passwords[i] = line.substr(p1 + 1, p2 - p1 - 1);
-                    roles[i] = line.substr(p2 + 1, p3 - p2 - 1);
-                    departments[i] = line.substr(p3 + 1);
-                    count++;
-                }
-            }
-        }
+        table_Resize(users, (int)data.rows.size());
+        table_Resize(users, journal_Parse(usersJournal, data, users.size(), users.col<UserName>(), users.col<UserPassword>(), users.col<UserRole>(), users.col<UserDept>()));
+        for (int r : usersJournal.tombstones)
+            table_Kill(users, r);
+        // Dropped rows shift the row numbers, rewrite the file before anything refers to them
+        if (usersJournal.outOfStep)
+            saveUsers(users);
     }
 }
 // For saving the hire applicants
-void saveHires(string users[], string roles[], string exp[], string status[], string names[], string edu[], int count)
+void saveHires(HireTable &hires)
 {
-    ofstream f("nasa_hires.csv");
-    if (f.is_open())
-    {
-        f << count << endl;
-        for (int i = 0; i < count; i++)
-            f << users[i] << "," << roles[i] << "," << exp[i] << "," << status[i] << "," << names[i] << "," << edu[i] << endl;
-    }
+    Column<string> &users = hires.col<HireUser>();
+    Column<DictString> &roles = hires.col<HireRole>();
+    Column<string> &exp = hires.col<HireExp>();
+    Column<DictString> &status = hires.col<HireStatus>();
+    Column<string> &names = hires.col<HireName>();
+    Column<string> &edu = hires.col<HireEdu>();
+    journal_Save(hiresJournal, to_string(hires.size()), hires.size(), [&](int i)
+                 { return users[i] + "," + roles[i] + "," + exp[i] + "," + status[i] + "," + names[i] + "," + edu[i]; });
 }
 // For loading the applicants
-void loadHires(string users[], string roles[], string exp[], string status[], string names[], string edu[], int &count)
+void loadHires(HireTable &hires)
 {
-    ifstream f("nasa_hires.csv");
-    if (f.is_open())
+    CsvData data;
+    if (journal_Load(hiresJournal, data))
     {
-        int cnt;
-        f >> cnt;
-        f.ignore(1000, '\n');
-        count = 0;
-        string line;
-        for (int i = 0; i < cnt; i++)
-        {
-            if (getline(f, line))
-            {
-                size_t p1 = line.find(',');
-                size_t p2 = line.find(',', p1 + 1);
-                size_t p3 = line.find(',', p2 + 1);
-                size_t p4 = line.find(',', p3 + 1);
-                size_t p5 = line.find(',', p4 + 1);
-                if (p5 != string::npos)
-                {
-                    users[i] = line.substr(0, p1);
-                    roles[i] = line.substr(p1 + 1, p2 - p1 - 1);
-                    exp[i] = line.substr(p2 + 1, p3 - p2 - 1);
-                    status[i] = line.substr(p3 + 1, p4 - p3 - 1);
-                    names[i] = line.substr(p4 + 1, p5 - p4 - 1);
-                    edu[i] = line.substr(p5 + 1);
-                    count++;
-                }
-            }
-        }
+        table_Resize(hires, (int)data.rows.size());
+        table_Resize(hires, journal_Parse(hiresJournal, data, hires.size(), hires.col<HireUser>(), hires.col<HireRole>(), hires.col<HireExp>(), hires.col<HireStatus>(), hires.col<HireName>(), hires.col<HireEdu>()));
+        if (hiresJournal.outOfStep)
+            saveHires(hires);
     }
+    indexHires(hires);
+}
+// Rebuilds the applicant and review-queue indexes from the loaded applications
+void indexHires(HireTable &hires)
+{
+    auto live = [&](int i)
+    { return table_Live(hires, i); };
+    rowset_Build(hiresByUser, hires.col<HireUser>(), live);
+    rowset_Build(hiresByStatus, hires.col<HireStatus>(), live);
 }
 // For saving the missions
-void saveMissions(int count, string names[], string status[], string requesters[], double costs[], double budget, string dates[])
+void saveMissions(MissionTable &missions, double budget)
 {
-    ofstream f("nasa_missions.csv");
-    if (f.is_open())
-    {
-        f << count << "," << budget << endl;
-        for (int i = 0; i < count; i++)
-            f << names[i] << "," << status[i] << "," << requesters[i] << "," << costs[i] << "," << dates[i] << endl;
-    }
+    Column<string> &names = missions.col<MissionName>();
+    Column<DictString> &status = missions.col<MissionStatus>();
+    Column<string> &requesters = missions.col<MissionRequester>();
+    Column<double> &costs = missions.col<MissionCost>();
+    Column<string> &dates = missions.col<MissionDate>();
+    ostringstream header;
+    header << missions.size() << "," << budget;
+    journal_Save(missionsJournal, header.str(), missions.size(), [&](int i)
+                 {
+                     if (!table_Live(missions, i))
+                         return string();
+                     ostringstream row;
+                     row << names[i] << "," << status[i] << "," << requesters[i] << "," << costs[i] << "," << dates[i];
+                     return row.str(); });
 }
 // For loading the missions
-void loadMissions(int &count, string names[], string codes[], string vehicles[], string status[], double budgets[], string requesters[], double costs[], double &agencyBudget, string dates[])
-{
-    ifstream f("nasa_missions.csv");
-    if (f.is_open())
-    {
-        int cnt;
-        double bud;
-        char c;
-        f >> cnt >> c >> bud; // Read int, comma, double
-        f.ignore(1000, '\n');
-        agencyBudget = bud;
-        count = 0;
-        string line;
-        for (int i = 0; i < cnt && i < MAX_MISSIONS; i++)
-        {
-            if (getline(f, line))
-            {
-                size_t p1 = line.find(',');
-                size_t p2 = line.find(',', p1 + 1);
-                size_t p3 = line.find(',', p2 + 1);
-                size_t p4 = line.find(',', p3 + 1);
-                if (p4 != string::npos)
-                {
-                    names[i] = line.substr(0, p1);
-                    status[i] = line.substr(p1 + 1, p2 - p1 - 1);
-                    requesters[i] = line.substr(p2 + 1, p3 - p2 - 1);
-                    costs[i] = safeStod(line.substr(p3 + 1, p4 - p3 - 1));
-                    dates[i] = line.substr(p4 + 1);
-                    codes[i] = "MSN-" + to_string(i + 101);
-                    vehicles[i] = "TBD";
-                    budgets[i] = costs[i];
-                    count++;
-                }
-            }
+void loadMissions(MissionTable &missions, double &agencyBudget)
+{
+    CsvData data;
+    if (journal_Load(missionsJournal, data))
+    {
+        size_t comma = data.header.find(','); // count, budget
+        if (comma != string_view::npos)
+            csv_Field(data.header.substr(comma + 1), agencyBudget);
+        table_Resize(missions, (int)data.rows.size());
+        table_Resize(missions, journal_Parse(missionsJournal, data, missions.size(), missions.col<MissionName>(), missions.col<MissionStatus>(), missions.col<MissionRequester>(), missions.col<MissionCost>(), missions.col<MissionDate>()));
+        for (int r : missionsJournal.tombstones)
+            table_Kill(missions, r);
+        // Codes, vehicles and budgets are not stored in the file
+        for (int i = 0; i < missions.size(); i++)
+        {
+            if (!table_Live(missions, i))
+                continue;
+            auto m = missions[i];
+            m.get<MissionCode>() = "MSN-" + to_string(i + 101);
+            m.get<MissionVehicle>() = "TBD";
+            m.get<MissionBudget>() = m.get<MissionCost>();
         }
+        if (missionsJournal.outOfStep)
+            saveMissions(missions, agencyBudget);
     }
 }
 // For Saving Astronauts
-void saveAstronauts(int count, string names[], string ranks[], string status[])
+void saveAstronauts(AstroTable &astros)
 {
-    ofstream f("nasa_astro.csv");
-    if (f.is_open())
-    {
-        f << count << endl;
-        for (int i = 0; i < count; i++)
-            f << names[i] << "," << ranks[i] << "," << status[i] << endl;
-    }
+    Column<string> &names = astros.col<AstroName>();
+    Column<DictString> &ranks = astros.col<AstroRank>();
+    Column<DictString> &status = astros.col<AstroStatus>();
+    journal_Save(astroJournal, to_string(astros.size()), astros.size(), [&](int i)
+                 { return names[i] + "," + ranks[i] + "," + status[i]; });
 }
 // For loading Astronauts
-void loadAstronauts(int &count, string names[], string ranks[], string status[])
+void loadAstronauts(AstroTable &astros)
 {
-    ifstream f("nasa_astro.csv");
-    if (f.is_open())
+    CsvData data;
+    if (journal_Load(astroJournal, data) && !data.rows.empty())
     {
-        int cnt;
-        f >> cnt;
-        f.ignore(1000, '\n');
-        if (cnt > 0)
-            count = 0;
-        string line;
-        for (int i = 0; i < cnt; i++)
-        {
-            if (getline(f, line))
-            {
-                size_t p1 = line.find(',');
-                size_t p2 = line.find(',', p1 + 1);
-                if (p2 != string::npos)
-                {
-                    names[i] = line.substr(0, p1);
-                    ranks[i] = line.substr(p1 + 1, p2 - p1 - 1);
-                    status[i] = line.substr(p2 + 1);
-                    count++;
-                }
-            }
-        }
+        table_Resize(astros, (int)data.rows.size());
+        table_Resize(astros, journal_Parse(astroJournal, data, astros.size(), astros.col<AstroName>(), astros.col<AstroRank>(), astros.col<AstroStatus>()));
+        if (astroJournal.outOfStep)
+            saveAstronauts(astros);
     }
 }
 // For saving inventory
-void saveInventory(int count, string names[], string cats[], double qtys[], string units[], double costs[])
+void saveInventory(InventoryTable &inv)
 {
-    ofstream f("nasa_inv.csv");
-    if (f.is_open())
-    {
-        f << count << endl;
-        for (int i = 0; i < count; i++)
-            f << names[i] << "," << cats[i] << "," << qtys[i] << "," << units[i] << "," << costs[i] << endl;
-    }
+    Column<string> &names = inv.col<InvName>();
+    Column<DictString> &cats = inv.col<InvCat>();
+    Column<double> &qtys = inv.col<InvQty>();
+    Column<DictString> &units = inv.col<InvUnit>();
+    Column<double> &costs = inv.col<InvCost>();
+    journal_Save(invJournal, to_string(inv.size()), inv.size(), [&](int i)
+                 {
+                     if (!table_Live(inv, i))
+                         return string();
+                     ostringstream row;
+                     row << names[i] << "," << cats[i] << "," << qtys[i] << "," << units[i] << "," << costs[i];
+                     return row.str(); });
 }
 // For loading inventory
-void loadInventory(int &count, string names[], string cats[], double qtys[], string units[], double costs[])
+void loadInventory(InventoryTable &inv)
 {
-    ifstream f("nasa_inv.csv");
-    if (f.is_open())
+    CsvData data;
+    if (journal_Load(invJournal, data) && !data.rows.empty())
     {
-        int cnt;
-        f >> cnt;
-        f.ignore(1000, '\n');
-        if (cnt > 0)
-            count = 0;
-        string line;
-        for (int i = 0; i < cnt; i++)
-        {
-            if (getline(f, line))
-            {
-                size_t p1 = line.find(',');
-                size_t p2 = line.find(',', p1 + 1);
-                size_t p3 = line.find(',', p2 + 1);
-                size_t p4 = line.find(',', p3 + 1);
-                if (p4 != string::npos)
-                {
-                    names[i] = line.substr(0, p1);
-                    cats[i] = line.substr(p1 + 1, p2 - p1 - 1);
-                    qtys[i] = safeStod(line.substr(p2 + 1, p3 - p2 - 1));
-                    units[i] = line.substr(p3 + 1, p4 - p3 - 1);
-                    costs[i] = safeStod(line.substr(p4 + 1));
-                    count++;
-                }
-            }
-        }
+        table_Resize(inv, (int)data.rows.size());
+        table_Resize(inv, journal_Parse(invJournal, data, inv.size(), inv.col<InvName>(), inv.col<InvCat>(), inv.col<InvQty>(), inv.col<InvUnit>(), inv.col<InvCost>()));
+        for (int r : invJournal.tombstones)
+            table_Kill(inv, r);
+        if (invJournal.outOfStep)
+            saveInventory(inv);
     }
 }
 // For saving planets
-void savePlanets(int count, string names[], string types[], double dists[], double gravs[], string atms[])
+void savePlanets(PlanetTable &planets)
 {
-    ofstream f("nasa_planets.csv");
-    if (f.is_open())
-    {
-        f << count << endl;
-        for (int i = 0; i < count; i++)
-            f << names[i] << "," << types[i] << "," << dists[i] << "," << gravs[i] << "," << atms[i] << endl;
-    }
+    Column<string> &names = planets.col<PlanetName>();
+    Column<DictString> &types = planets.col<PlanetType>();
+    Column<double> &dists = planets.col<PlanetDist>();
+    Column<double> &gravs = planets.col<PlanetGrav>();
+    Column<string> &atms = planets.col<PlanetAtm>();
+    journal_Save(planetsJournal, to_string(planets.size()), planets.size(), [&](int i)
+                 {
+                     if (!table_Live(planets, i))
+                         return string();
+                     ostringstream row;
+                     row << names[i] << "," << types[i] << "," << dists[i] << "," << gravs[i] << "," << atms[i];
+                     return row.str(); });
 }
 // for loading planets
-void loadPlanets(int &count, string names[], string types[], double dists[], double gravs[], string atms[])
+void loadPlanets(PlanetTable &planets)
 {
-    ifstream f("nasa_planets.csv");
-    if (f.is_open())
+    CsvData data;
+    if (journal_Load(planetsJournal, data) && !data.rows.empty())
     {
-        int cnt;
-        f >> cnt;
-        f.ignore(1000, '\n');
-        if (cnt > 0)
-            count = 0;
-        string line;
-        for (int i = 0; i < cnt; i++)
-        {
-            if (getline(f, line))
-            {
-                size_t p1 = line.find(',');
-                size_t p2 = line.find(',', p1 + 1);
-                size_t p3 = line.find(',', p2 + 1);
-                size_t p4 = line.find(',', p3 + 1);
-                if (p4 != string::npos)
-                {
-                    names[i] = line.substr(0, p1);
-                    types[i] = line.substr(p1 + 1, p2 - p1 - 1);
-                    dists[i] = safeStod(line.substr(p2 + 1, p3 - p2 - 1));
-                    gravs[i] = safeStod(line.substr(p3 + 1, p4 - p3 - 1));
-                    atms[i] = line.substr(p4 + 1);
-                    count++;
-                }
-            }
-        }
+        table_Resize(planets, (int)data.rows.size());
+        table_Resize(planets, journal_Parse(planetsJournal, data, planets.size(), planets.col<PlanetName>(), planets.col<PlanetType>(), planets.col<PlanetDist>(), planets.col<PlanetGrav>(), planets.col<PlanetAtm>()));
+        for (int r : planetsJournal.tombstones)
+            table_Kill(planets, r);
+        if (planetsJournal.outOfStep)
+            savePlanets(planets);
     }
 }
 // For saving exoplanets
-void saveExoplanets(int count, string names[], double dists[], string types[], bool habitable[])
+void saveExoplanets(ExoplanetTable &exos)
+{
+    Column<string> &names = exos.col<ExoName>();
+    Column<double> &dists = exos.col<ExoDist>();
+    Column<DictString> &types = exos.col<ExoType>();
+    Column<bool> &habitable = exos.col<ExoHabitable>();
+    journal_Save(exoJournal, to_string(exos.size()), exos.size(), [&](int i)
+                 {
+                     if (!table_Live(exos, i))
+                         return string();
+                     ostringstream row;
+                     row << names[i] << "," << dists[i] << "," << types[i] << "," << habitable[i];
+                     return row.str(); });
+}
+// For loading exoplanets
+void loadExoplanets(ExoplanetTable &exos)
 {
-    ofstream f("nasa_exo.csv");
-    if (f.is_open())
+    CsvData data;
+    if (journal_Load(exoJournal, data) && !data.rows.empty())
     {
-        f << count << endl;
-        for (int i = 0; i < count; i++)
-            f << names[i] << "," << dists[i] << "," << types[i] << "," << habitable[i] << endl;
+        table_Resize(exos, (int)data.rows.size());
+        table_Resize(exos, journal_Parse(exoJournal, data, exos.size(), exos.col<ExoName>(), exos.col<ExoDist>(), exos.col<ExoType>(), exos.col<ExoHabitable>()));
+        for (int r : exoJournal.tombstones)
+            table_Kill(exos, r);
+        if (exoJournal.outOfStep)
+            saveExoplanets(exos);
     }
 }
-// For loading exoplanets
-void loadExoplanets(int &count, string names[], double dists[], string types[], bool habitable[])
+// Snapshot helpers
+// Finds a table in the snapshot and checks it still matches its CSV files
+bool snapTable(const SnapshotFile &snap, string name, const Journal &j, uint32_t columns, SnapTable &t)
+{
+    return snap.data && snap_Find(snap, name, t) && t.desc->stamp == journal_Stamp(j) && t.desc->columnCount == columns && t.rows <= (uint64_t)numeric_limits<int>::max();
+}
+// Copies one snapshot column into a table column
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<string> &out)
+{
+    const SnapStr *col = snap_StringColumn(snap, t, c);
+    for (uint64_t i = 0; col && i < t.rows; i++)
+        out[i] = snap_String(snap, col[i]);
+    return col != nullptr;
+}
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<DictString> &out)
+{
+    const SnapStr *col = snap_StringColumn(snap, t, c);
+    for (uint64_t i = 0; col && i < t.rows; i++)
+        out[i] = snap_String(snap, col[i]);
+    return col != nullptr;
+}
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<double> &out)
+{
+    const double *col = snap_DoubleColumn(snap, t, c);
+    for (uint64_t i = 0; col && i < t.rows; i++)
+        out[i] = col[i];
+    return col != nullptr;
+}
+bool snapColumn(const SnapshotFile &snap, const SnapTable &t, uint32_t c, Column<bool> &out)
+{
+    const uint8_t *col = snap_BoolColumn(snap, t, c);
+    for (uint64_t i = 0; col && i < t.rows; i++)
+        out[i] = (col[i] != 0);
+    return col != nullptr;
+}
+// For restoring users from the snapshot
+bool snapUsers(const SnapshotFile &snap, UserTable &users)
 {
-    ifstream f("nasa_exo.csv");
-    if (f.is_open())
+    SnapTable t;
+    if (!snapTable(snap, "users", usersJournal, 5, t))
+        return false;
+    table_Resize(users, (int)t.rows);
+    if (!snapColumn(snap, t, 0, users.col<UserName>()) || !snapColumn(snap, t, 1, users.col<UserPassword>()) ||
+        !snapColumn(snap, t, 2, users.col<UserRole>()) || !snapColumn(snap, t, 3, users.col<UserDept>()) ||
+        !snapColumn(snap, t, 4, users.dead))
     {
-        int cnt;
-        f >> cnt;
-        f.ignore(1000, '\n');
-        if (cnt > 0)
-            count = 0;
-        string line;
-        for (int i = 0; i < cnt && i < MAX_PLANETS; i++)
-        {
-            if (getline(f, line))
-            {
-                size_t p1 = line.find(',');
-                size_t p2 = line.find(',', p1 + 1);
-                size_t p3 = line.find(',', p2 + 1);
-                if (p3 != string::npos)
-                {
-                    names[i] = line.substr(0, p1);
-                    dists[i] = safeStod(line.substr(p1 + 1, p2 - p1 - 1));
-                    types[i] = line.substr(p2 + 1, p3 - p2 - 1);
-                    habitable[i] = (line.substr(p3 + 1) == "1");
-                    count++;
-                }
-            }
-        }
+        table_Resize(users, 0);
+        return false;
     }
+    table_Refresh(users);
+    journal_Attach(usersJournal, users.size(), to_string(users.size()));
+    return true;
 }
-// For saving the activities logs
-void saveLogs(int count, string actions[])
+// For restoring hire applications from the snapshot
+bool snapHires(const SnapshotFile &snap, HireTable &hires)
 {
-    ofstream f("nasa_logs.csv");
-    if (f.is_open())
+    SnapTable t;
+    if (!snapTable(snap, "hires", hiresJournal, 6, t))
+        return false;
+    table_Resize(hires, (int)t.rows);
+    if (!snapColumn(snap, t, 0, hires.col<HireUser>()) || !snapColumn(snap, t, 1, hires.col<HireRole>()) ||
+        !snapColumn(snap, t, 2, hires.col<HireExp>()) || !snapColumn(snap, t, 3, hires.col<HireStatus>()) ||
+        !snapColumn(snap, t, 4, hires.col<HireName>()) || !snapColumn(snap, t, 5, hires.col<HireEdu>()))
     {
-        f << count << endl;
-        for (int i = 0; i < count; i++)
-            f << actions[i] << endl;
+        table_Resize(hires, 0);
+        return false;
     }
+    journal_Attach(hiresJournal, hires.size(), to_string(hires.size()));
+    indexHires(hires);
+    return true;
 }
-// For loading the activities logs
-void loadLogs(int &count, string actions[])
+// For restoring missions and the agency budget from the snapshot
+bool snapMissions(const SnapshotFile &snap, MissionTable &missions, double &agencyBudget)
 {
-    ifstream f("nasa_logs.csv");
-    if (f.is_open())
+    SnapTable t, a;
+    const double *budget = nullptr;
+    if (!snapTable(snap, "missions", missionsJournal, 9, t) || !snapTable(snap, "agency", missionsJournal, 1, a) || a.rows != 1 ||
+        !(budget = snap_DoubleColumn(snap, a, 0)))
+        return false;
+    table_Resize(missions, (int)t.rows);
+    if (!snapColumn(snap, t, 0, missions.col<MissionName>()) || !snapColumn(snap, t, 1, missions.col<MissionCode>()) ||
+        !snapColumn(snap, t, 2, missions.col<MissionDate>()) || !snapColumn(snap, t, 3, missions.col<MissionVehicle>()) ||
+        !snapColumn(snap, t, 4, missions.col<MissionStatus>()) || !snapColumn(snap, t, 5, missions.col<MissionBudget>()) ||
+        !snapColumn(snap, t, 6, missions.col<MissionRequester>()) || !snapColumn(snap, t, 7, missions.col<MissionCost>()) ||
+        !snapColumn(snap, t, 8, missions.dead))
     {
-        f >> count;
-        f.ignore(1000, '\n');
-        int max = count;
-        count = 0;
-        string l;
-        for (int i = 0; i < max; i++)
-        {
-            if (getline(f, l) && count < MAX_LOGS)
-                actions[count++] = l;
-        }
+        table_Resize(missions, 0);
+        return false;
     }
+    table_Refresh(missions);
+    agencyBudget = *budget;
+    ostringstream header;
+    header << missions.size() << "," << agencyBudget;
+    journal_Attach(missionsJournal, missions.size(), header.str());
+    return true;
 }
-// for adding something into the log
-void addLog(string action, string logActions[], int &logCount)
+// For restoring inventory from the snapshot
+bool snapInventory(const SnapshotFile &snap, InventoryTable &inv)
+{
+    SnapTable t;
+    if (!snapTable(snap, "inventory", invJournal, 6, t))
+        return false;
+    table_Resize(inv, (int)t.rows);
+    if (!snapColumn(snap, t, 0, inv.col<InvName>()) || !snapColumn(snap, t, 1, inv.col<InvCat>()) ||
+        !snapColumn(snap, t, 2, inv.col<InvQty>()) || !snapColumn(snap, t, 3, inv.col<InvUnit>()) ||
+        !snapColumn(snap, t, 4, inv.col<InvCost>()) ||
+        !snapColumn(snap, t, 5, inv.dead))
+    {
+        table_Resize(inv, 0);
+        return false;
+    }
+    table_Refresh(inv);
+    journal_Attach(invJournal, inv.size(), to_string(inv.size()));
+    return true;
+}
+// For restoring astronauts from the snapshot
+bool snapAstronauts(const SnapshotFile &snap, AstroTable &astros)
+{
+    SnapTable t;
+    if (!snapTable(snap, "astronauts", astroJournal, 3, t))
+        return false;
+    table_Resize(astros, (int)t.rows);
+    if (!snapColumn(snap, t, 0, astros.col<AstroName>()) || !snapColumn(snap, t, 1, astros.col<AstroRank>()) ||
+        !snapColumn(snap, t, 2, astros.col<AstroStatus>()))
+    {
+        table_Resize(astros, 0);
+        return false;
+    }
+    journal_Attach(astroJournal, astros.size(), to_string(astros.size()));
+    return true;
+}
+// For restoring planets from the snapshot
+bool snapPlanets(const SnapshotFile &snap, PlanetTable &planets)
+{
+    SnapTable t;
+    if (!snapTable(snap, "planets", planetsJournal, 6, t))
+        return false;
+    table_Resize(planets, (int)t.rows);
+    if (!snapColumn(snap, t, 0, planets.col<PlanetName>()) || !snapColumn(snap, t, 1, planets.col<PlanetType>()) ||
+        !snapColumn(snap, t, 2, planets.col<PlanetDist>()) || !snapColumn(snap, t, 3, planets.col<PlanetGrav>()) ||
+        !snapColumn(snap, t, 4, planets.col<PlanetAtm>()) ||
+        !snapColumn(snap, t, 5, planets.dead))
+    {
+        table_Resize(planets, 0);
+        return false;
+    }
+    table_Refresh(planets);
+    journal_Attach(planetsJournal, planets.size(), to_string(planets.size()));
+    return true;
+}
+// For restoring exoplanets from the snapshot
+bool snapExoplanets(const SnapshotFile &snap, ExoplanetTable &exos)
 {
-    if (logCount < MAX_LOGS)
+    SnapTable t;
+    if (!snapTable(snap, "exoplanets", exoJournal, 5, t))
+        return false;
+    table_Resize(exos, (int)t.rows);
+    if (!snapColumn(snap, t, 0, exos.col<ExoName>()) || !snapColumn(snap, t, 1, exos.col<ExoDist>()) ||
+        !snapColumn(snap, t, 2, exos.col<ExoType>()) || !snapColumn(snap, t, 3, exos.col<ExoHabitable>()) ||
+        !snapColumn(snap, t, 4, exos.dead))
     {
-        logActions[logCount++] = action;
-        saveLogs(logCount, logActions);
+        table_Resize(exos, 0);
+        return false;
     }
+    table_Refresh(exos);
+    journal_Attach(exoJournal, exos.size(), to_string(exos.size()));
+    return true;
+}
+// For writing every table into the binary snapshot
+void saveSnapshot(Database &db)
+{
+    // Stamps are only meaningful once pending compactions have replaced their base files
+    Journal *journals[] = {&usersJournal, &hiresJournal, &missionsJournal, &invJournal, &astroJournal, &planetsJournal, &exoJournal};
+    for (Journal *j : journals)
+        journal_Wait(*j);
+
+    SnapshotWriter w;
+    snap_Table(w, "users", db.users.size(), journal_Stamp(usersJournal));
+    snap_Strings(w, db.users.col<UserName>());
+    snap_Strings(w, db.users.col<UserPassword>());
+    snap_Strings(w, db.users.col<UserRole>());
+    snap_Strings(w, db.users.col<UserDept>());
+    snap_Bools(w, db.users.dead);
+
+    snap_Table(w, "hires", db.hires.size(), journal_Stamp(hiresJournal));
+    snap_Strings(w, db.hires.col<HireUser>());
+    snap_Strings(w, db.hires.col<HireRole>());
+    snap_Strings(w, db.hires.col<HireExp>());
+    snap_Strings(w, db.hires.col<HireStatus>());
+    snap_Strings(w, db.hires.col<HireName>());
+    snap_Strings(w, db.hires.col<HireEdu>());
+
+    snap_Table(w, "missions", db.missions.size(), journal_Stamp(missionsJournal));
+    snap_Strings(w, db.missions.col<MissionName>());
+    snap_Strings(w, db.missions.col<MissionCode>());
+    snap_Strings(w, db.missions.col<MissionDate>());
+    snap_Strings(w, db.missions.col<MissionVehicle>());
+    snap_Strings(w, db.missions.col<MissionStatus>());
+    snap_Doubles(w, db.missions.col<MissionBudget>());
+    snap_Strings(w, db.missions.col<MissionRequester>());
+    snap_Doubles(w, db.missions.col<MissionCost>());
+    snap_Bools(w, db.missions.dead);
+    snap_Table(w, "agency", 1, journal_Stamp(missionsJournal));
+    snap_Doubles(w, &db.agencyBudget);
+
+    snap_Table(w, "inventory", db.inventory.size(), journal_Stamp(invJournal));
+    snap_Strings(w, db.inventory.col<InvName>());
+    snap_Strings(w, db.inventory.col<InvCat>());
+    snap_Doubles(w, db.inventory.col<InvQty>());
+    snap_Strings(w, db.inventory.col<InvUnit>());
+    snap_Doubles(w, db.inventory.col<InvCost>());
+    snap_Bools(w, db.inventory.dead);
+
+    snap_Table(w, "astronauts", db.astronauts.size(), journal_Stamp(astroJournal));
+    snap_Strings(w, db.astronauts.col<AstroName>());
+    snap_Strings(w, db.astronauts.col<AstroRank>());
+    snap_Strings(w, db.astronauts.col<AstroStatus>());
+
+    snap_Table(w, "planets", db.planets.size(), journal_Stamp(planetsJournal));
+    snap_Strings(w, db.planets.col<PlanetName>());
+    snap_Strings(w, db.planets.col<PlanetType>());
+    snap_Doubles(w, db.planets.col<PlanetDist>());
+    snap_Doubles(w, db.planets.col<PlanetGrav>());
+    snap_Strings(w, db.planets.col<PlanetAtm>());
+    snap_Bools(w, db.planets.dead);
+
+    snap_Table(w, "exoplanets", db.exoplanets.size(), journal_Stamp(exoJournal));
+    snap_Strings(w, db.exoplanets.col<ExoName>());
+    snap_Doubles(w, db.exoplanets.col<ExoDist>());
+    snap_Strings(w, db.exoplanets.col<ExoType>());
+    snap_Bools(w, db.exoplanets.col<ExoHabitable>());
+    snap_Bools(w, db.exoplanets.dead);
+
+    snap_Write(w, "nasa_snapshot.bin");
+}
+// For loading the activities logs
+// Only the newest segment is scanned, older history stays on disk until it is paged in
+void loadLogs(LogStore &logs)
+{
+    log_Open(logs);
+}
+// for adding something into the log
+void addLog(string action, LogStore &logs)
+{
+    log_Append(logs, action);
 }
 
 // Utilitiies for different general actions
@@ -2169,7 +3126,7 @@ void about()
 
     gotoxy(18, 27);
     cout << GRN << "Press any key..." << RST;
-    _getch();
+    getKey();
 }
 void history()
 {
@@ -2204,33 +3161,131 @@ void history()
 
     gotoxy(10, 29);
     cout << GRN << "Press any key..." << RST;
-    _getch();
+    getKey();
 }
 void exit()
 {
-    system("cls");
+    clearScreen();
     gotoxy(5, 5);
     cout << RD << "SHUTTING DOWN SYSTEM..." << RST << endl;
-    Sleep(1000);
+    term_Sleep(1000);
     exit(0);
 }
-// For coordination and positioning
+// For coordination and positioning, whatever is written there is not part of the menu screens
 void gotoxy(int x, int y)
 {
-    COORD coordinates;
-    coordinates.X = x;
-    coordinates.Y = y;
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coordinates);
+    ui_Invalidate(console);
+    term_GotoXY(x, y);
 }
 // For hidding the cursor while loading the app
 void setCursor(bool visible)
 {
     cout << (visible ? "\033[?25h" : "\033[?25l");
 }
-// Displaying the logo
+// For showing the redraw cost of the previous frame under a simulation
+string frameStatus(const FrameStats &stats)
+{
+    ostringstream ss;
+    ss << fixed << setprecision(3) << "Redraw " << stats.frameMs << " ms, " << stats.cells << " cells, " << stats.bytes << " bytes";
+    return ss.str();
+}
+// Shows a table view until the user goes back, only the rows on screen are formatted.
+// row(pos, r) fills in the row at a position of the view, find(id) gives the position of
+// the record with that ID for the jump key.
+void pageTable(PagerView &view, long long count, const function<void(long long, PagerRow &)> &row, const function<long long(long long)> &find)
+{
+    const string keys = "[PgUp/PgDn] Page  [Up/Down] Scroll  [Home/End] First/Last  [J] Jump to ID  [B] Back";
+    string jump;
+    bool jumping = false;
+    while (true)
+    {
+        pager_Draw(console.frame, view, count, row, jumping ? "Jump to ID: " + jump + "_  [Enter] Go  [Esc] Cancel" : keys);
+        frame_Flush(console.frame, cout);
+        console.shown = nullptr;
+
+        int c = getKey();
+        if (jumping)
+        {
+            if (c >= '0' && c <= '9' && jump.size() < 18)
+                jump += (char)c;
+            else if ((c == 8 || c == 127) && !jump.empty())
+                jump.pop_back();
+            else if (c == '\r' || c == 27)
+            {
+                if (c == '\r' && !jump.empty())
+                {
+                    view.top = find(stoll(jump));
+                    pager_Clamp(view, count);
+                }
+                jumping = false;
+                jump.clear();
+            }
+            continue;
+        }
+        if (c == 'b' || c == 'B' || c == 27)
+            return;
+        if (c == 'j' || c == 'J')
+            jumping = true;
+        else
+            pager_Key(view, c, count);
+    }
+}
+// Rows of a table that are not tombstones, in ID order
+template <class T>
+vector<int> liveRows(const T &t)
+{
+    vector<int> rows;
+    rows.reserve(t.size() - t.deadRows);
+    for (int i = 0; i < t.size(); i++)
+        if (!t.dead[i])
+            rows.push_back(i);
+    return rows;
+}
+// Position of the record with a 1-based ID among rows, or of the next one after it
+long long rowPosition(const vector<int> &rows, long long id)
+{
+    return lower_bound(rows.begin(), rows.end(), id - 1) - rows.begin();
+}
+// A number as cout prints it by default
+string formatNumber(double v)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%g", v);
+    return buf;
+}
+// A total with two decimals and thousands separators, e.g. 12,507.50
+string formatAmount(double v)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.2f", v < 0 ? -v : v);
+    string digits = buf, out;
+    size_t point = digits.find('.');
+    for (size_t i = 0; i < point; i++)
+    {
+        if (i > 0 && (point - i) % 3 == 0)
+            out += ',';
+        out += digits[i];
+    }
+    return (v < 0 ? "-" : "") + out + digits.substr(point);
+}
+// For clearing the console without starting a cls process
+void clearScreen()
+{
+    term_Clear();
+    ui_Invalidate(console);
+}
+// Displaying the logo, the still logo is a cached screen so redrawing it costs nothing
 void drawLogo(bool animate)
 {
-    system("cls");
+    if (!animate)
+    {
+        static UiScreen logo;
+        if (logo.widgets.empty())
+            addLogo(logo);
+        ui_Show(console, logo, cout);
+        return;
+    }
+    clearScreen();
     int X = 20;
     int Y = 3;
     string logo[] = {
@@ -2249,14 +3304,7 @@ void drawLogo(bool animate)
     for (int i = 0; i < 6; i++)
     {
         gotoxy(X, Y + i);
-        if (animate)
-        {
-            animations(logo[i], 5);
-        }
-        else
-        {
-            cout << logo[i];
-        }
+        animations(logo[i], 5);
         if (i < 5)
         {
             cout << ufo[i];
@@ -2265,14 +3313,41 @@ void drawLogo(bool animate)
     }
 
     gotoxy(X + 15, Y + 7);
-    if (animate)
-    {
-        animations(CYN + "Taking you beyond the horizon... " + RST, 20);
-    }
-    else
+    animations(CYN + "Taking you beyond the horizon... " + RST, 20);
+}
+// For putting the logo on a menu screen, where drawLogo draws it
+void addLogo(UiScreen &screen)
+{
+    int X = 20;
+    int Y = 3;
+    string logo[] = {
+        "  _   _      _    ____      _    ",
+        " | \\ | |    / \\  / ___|    / \\   ",
+        " |  \\| |   / _ \\ \\___ \\   / _ \\  ",
+        " | |\\  |  / ___ \\ ___) | / ___ \\ ",
+        " |_| \\_| /_/   \\_\\____/ /_/   \\_\\"};
+    string ufo[] = {
+        "       _.---._    ",
+        "     .'       '.  ",
+        " _.-~___________~-._",
+        "(___________________)",
+        "     I  I  I  I   "};
+    for (int i = 0; i < 5; i++)
     {
-        cout << CYN + "Taking you beyond the horizon..." + RST;
+        ui_Text(screen, X, Y + i, logo[i], FC_RED);
+        ui_Text(screen, X + (int)logo[i].size(), Y + i, ufo[i], FC_CYAN);
     }
+    ui_Text(screen, X, Y + 5, "              MANAGEMENT SYSTEM", FC_YELLOW);
+    ui_Text(screen, X + 15, Y + 7, "Taking you beyond the horizon...", FC_CYAN);
+}
+// For building the screen of a department menu: logo, box, title and one line per option
+void buildMenu(UiScreen &screen, string title, uint8_t color, int boxHeight, const vector<string> &items)
+{
+    addLogo(screen);
+    ui_Box(screen, 10, 11, 80, boxHeight);
+    ui_Text(screen, 35, 12, title, color);
+    for (size_t i = 0; i < items.size(); i++)
+        ui_Text(screen, 20, 14 + (int)i, items[i]);
 }
 // For drawing box around different sections
 void drawBox(int x, int y, int width, int height)
@@ -2302,14 +3377,13 @@ void animations(string t, int s)
     for (char c : t)
     {
         cout << c;
-        Sleep(s);
+        term_Sleep(s);
     }
 }
 // For clearing the buffer after any input so that it doesn't cause any issues
 void clearKeyboardBuffer()
 {
-    HANDLE hIn = GetStdHandle(STD_INPUT_HANDLE);
-    FlushConsoleInputBuffer(hIn);
+    term_FlushInput();
 }
 // For taking valid input and omitting out any error causing thing in input
 string getInput(string prompt)
@@ -2317,36 +3391,31 @@ string getInput(string prompt)
     cout << prompt;
     string input;
     getline(cin, input);
-    for (size_t i = 0; i < input.length(); i++)
+    return cleanField(input);
+}
+// For keeping the field separators of the data files out of a value
+string cleanField(string s)
+{
+    for (size_t i = 0; i < s.length(); i++)
     {
-        if (input[i] == ',' || input[i] == '|')
-            input[i] = ';';
+        if (s[i] == ',' || s[i] == '|')
+            s[i] = ';';
     }
-    return input;
+    return s;
 }
 
-// Safe conversions for CSV Loading
+// Safe conversions for CSV Loading, 0 when the text is not a number
 int safeStoi(string s)
 {
-    try
-    {
-        return stoi(s);
-    }
-    catch (...)
-    {
-        return 0;
-    }
+    int v;
+    csv_Field(s, v);
+    return v;
 }
 double safeStod(string s)
 {
-    try
-    {
-        return stod(s);
-    }
-    catch (...)
-    {
-        return 0.0;
-    }
+    double v;
+    csv_Field(s, v);
+    return v;
 }
 // For taking input within some range in integer
 int getInt(string p, int min, int max)
@@ -2365,6 +3434,8 @@ int getInt(string p, int min, int max)
             cin.ignore(1000, '\n');
             return v;
         }
+        if (cin.eof())
+            exit(0);
         cin.clear();
         cin.ignore(1000, '\n');
         cout << RD << "   Invalid Input. Range (" << min << "-" << max << "): " << RST;
@@ -2383,16 +3454,26 @@ double getDouble(string p, double min, double max)
             cin.ignore(1000, '\n');
             return v;
         }
+        if (cin.eof())
+            exit(0);
         cin.clear();
         cin.ignore(1000, '\n');
         cout << RD << "   Invalid Input. Range (" << min << "-" << max << "): " << RST;
     }
 }
 // For pausing and wait for user interaction
-void pause()
+void waitKey()
 {
     cout << "\n[Press Key]";
-    _getch();
+    getKey();
+}
+// For reading a single key, there is nothing left to do once the input is closed
+int getKey()
+{
+    int c = term_GetKey();
+    if (c == TERM_KEY_EOF)
+        exit(0);
+    return c;
 }
 // For checking username validity
 bool isValidUsername(string u)
@@ -2436,10 +3517,1171 @@ bool isValidPassword(string p)
 // To display a specific message
 void message(string msg)
 {
-    system("cls");
-    drawLogo();
-    drawBox(15, 12, 70, 5);
-    gotoxy(20, 14);
-    cout << RD << msg << RST;
-    pause();
+    static UiScreen screen;
+    static int text;
+    if (screen.widgets.empty())
+    {
+        addLogo(screen);
+        ui_Box(screen, 15, 12, 70, 5);
+        text = ui_Text(screen, 20, 14, "", FC_RED);
+        ui_Text(screen, 20, 15, "[Press Key]");
+    }
+    ui_Set(screen, text, msg);
+    ui_Show(console, screen, cout);
+    getKey();
+}
+
+// Queries
+// Runs q on the table it names, with the same access rules as the menus of that table
+bool runQuery(Database &db, string role, const Query &q, QueryResult &res, string &error)
+{
+    bool employee = (role != "visitor");
+    if ((q.table == "missions" || q.table == "inventory" || q.table == "astronauts") && !employee)
+    {
+        error = "restricted area, employees only";
+        return false;
+    }
+    if (q.table == "missions")
+        return query_Run(db.missions, q, res, error);
+    if (q.table == "inventory")
+        return query_Run(db.inventory, q, res, error);
+    if (q.table == "astronauts")
+        return query_Run(db.astronauts, q, res, error);
+    if (q.table == "planets")
+        return query_Run(db.planets, q, res, error);
+    if (q.table == "exoplanets")
+        return query_Run(db.exoplanets, q, res, error);
+    error = "unknown table " + q.table + ", use missions, inventory, astronauts, planets or exoplanets";
+    return false;
+}
+// The tables a query can name and their columns, one line each
+string queryTables(Database &db)
+{
+    string out;
+    auto add = [&](string name, const vector<QueryColumn> &cols)
+    {
+        out += name + ":";
+        for (const QueryColumn &c : cols)
+            out += string(" ") + c.name;
+        out += "\n";
+    };
+    add("missions", query_Columns(db.missions));
+    add("inventory", query_Columns(db.inventory));
+    add("astronauts", query_Columns(db.astronauts));
+    add("planets", query_Columns(db.planets));
+    add("exoplanets", query_Columns(db.exoplanets));
+    return out;
+}
+
+// Batch Mode
+// Runs a script of commands against the database without the console interface, one command
+// per line ('#' starts a comment). Nothing is saved until the script ends, then every table is
+// written out once. Returns the number of commands that failed.
+int batch_Run(istream &in, Database &db, LogStore &logs)
+{
+    int currentUserIdx = -1;
+    int done = 0, failed = 0;
+    logs.deferFlush = true;
+    string line;
+    for (long long n = 1; getline(in, line); n++)
+    {
+        vector<string> words = batch_Words(line);
+        if (words.empty() || words[0][0] == '#')
+            continue;
+        string error = batch_Exec(words, db, currentUserIdx, logs);
+        if (error.empty())
+            done++;
+        else
+        {
+            failed++;
+            cerr << "line " << n << ": " << error << "\n";
+        }
+    }
+    // One flush for the whole batch
+    saveUsers(db.users);
+    saveHires(db.hires);
+    saveMissions(db.missions, db.agencyBudget);
+    saveInventory(db.inventory);
+    saveAstronauts(db.astronauts);
+    savePlanets(db.planets);
+    saveExoplanets(db.exoplanets);
+    saveSnapshot(db);
+    log_Flush(logs);
+    cout << done << " commands done, " << failed << " failed\n";
+    return failed;
+}
+// Splits a script line into words, "double quotes" keep spaces inside one word
+vector<string> batch_Words(const string &line)
+{
+    vector<string> words;
+    size_t i = 0;
+    while (true)
+    {
+        while (i < line.size() && isspace((unsigned char)line[i]))
+            i++;
+        if (i >= line.size())
+            break;
+        string w;
+        if (line[i] == '"')
+        {
+            size_t end = line.find('"', i + 1);
+            if (end == string::npos)
+                end = line.size();
+            w = line.substr(i + 1, end - i - 1);
+            i = end + 1;
+        }
+        else
+        {
+            while (i < line.size() && !isspace((unsigned char)line[i]))
+                w += line[i++];
+        }
+        words.push_back(cleanField(w));
+    }
+    return words;
+}
+// Reads a number within the range the menus accept for the same field
+bool batch_Number(const string &word, double min, double max, double &out)
+{
+    return csv_Field(word, out) && out >= min && out <= max;
+}
+// Reads a 1-based record ID as the menus show it, false unless it names a live row
+template <class T>
+bool batch_Row(const string &word, const T &t, int &row)
+{
+    int id;
+    if (!csv_Field(word, id) || id < 1 || id > t.size() || !table_Live(t, id - 1))
+        return false;
+    row = id - 1;
+    return true;
+}
+// Sets the column labelled label (see TABLE_COLUMN) of one row from text, false when the
+// table has no such column or the text is not a valid value for it
+template <class... Cols>
+bool batch_SetField(Table<Cols...> &t, int row, const string &label, const string &text)
+{
+    bool found = false, ok = false;
+    auto set = [&](auto &col, const char *name)
+    {
+        if (!found && label == name)
+        {
+            found = true;
+            ok = csv_Field(text, col[row]);
+        }
+    };
+    (set(t.template col<Cols>(), Cols::name), ...);
+    return ok;
+}
+// Runs one command, returns what went wrong or an empty string
+//   signin <username> <password>
+//   mission request <name> <vehicle> <cost $B> | approve <id|all> | launch <id> [seed] | predict <id> [runs] [seed] | delete <id> | list [status]
+//   inventory add <name> <category> <qty> <unit> <cost $M> | delete <id> | list
+//   hire approve <id|all> | reject <id> | list
+//   planet add <name> <type> <distance AU> <gravity> <atmosphere> | set <id> <column> <value> | delete <id> | list
+//   import <inventory|astronauts|exoplanets> <file>
+//   query <table> [where ...] [by ...] [count|sum|avg|min|max ...] [order ...] [limit n]  (see query.h)
+//   dock <radial m> <along-track m> [radial m/s] [along-track m/s]
+string batch_Exec(const vector<string> &words, Database &db, int &currentUserIdx, LogStore &logs)
+{
+    Column<string> &usernames = db.users.col<UserName>();
+    Column<DictString> &roles = db.users.col<UserRole>();
+    string cmd = words[0], sub = (words.size() > 1 ? words[1] : "");
+    size_t argc = words.size();
+
+    if (cmd == "signin")
+    {
+        if (argc != 3)
+            return "usage: signin <username> <password>";
+        currentUserIdx = signIn(words[1], words[2], db.users, logs);
+        if (currentUserIdx < 0)
+            return "invalid credentials for " + words[1];
+        addLog("Login Success: " + words[1], logs);
+        return "";
+    }
+    if (currentUserIdx < 0)
+        return "sign in first";
+    string role = roles[currentUserIdx];
+    bool admin = (role == "admin"), employee = (role != "visitor");
+
+    if (cmd == "mission")
+    {
+        MissionTable &missions = db.missions;
+        Column<string> &names = missions.col<MissionName>();
+        Column<DictString> &status = missions.col<MissionStatus>();
+        int i;
+        if (!employee)
+            return "restricted area, employees only";
+        if (sub == "request")
+        {
+            double cost;
+            if (role == "guest")
+                return "guests cannot plan missions";
+            if (argc != 5 || !batch_Number(words[4], 0.1, 1000.0, cost))
+                return "usage: mission request <name> <vehicle> <cost $B>";
+            i = flight_InsertMission(missions, usernames[currentUserIdx], words[2], words[3], cost);
+            addLog("Mission Requested: " + words[2], logs);
+            cout << "mission " << i + 1 << " requested\n";
+            return "";
+        }
+        if (sub == "approve" && argc == 3)
+        {
+            if (!admin)
+                return "admin only";
+            vector<int> rows;
+            if (words[2] == "all")
+                rows = rowset_Rows(missionsByStatus, "Pending");
+            else if (batch_Row(words[2], missions, i) && status[i] == "Pending")
+                rows.push_back(i);
+            else
+                return "no pending mission " + words[2];
+            for (int r : rows)
+            {
+                if (!admin_FundMission(missions, db.agencyBudget, r))
+                    return "insufficient funds for mission " + to_string(r + 1);
+                addLog("Funded Mission: " + names[r], logs);
+                cout << "mission " << r + 1 << " funded\n";
+            }
+            return "";
+        }
+        if (sub == "launch" && (argc == 3 || argc == 4))
+        {
+            // A seed from the log replays that launch
+            uint64_t seed = rng_Next(rng);
+            if (!batch_Row(words[2], missions, i))
+                return "no mission " + words[2];
+            if (argc == 4 && !csv_Field(words[3], seed))
+                return "usage: mission launch <id> [seed]";
+            if (status[i] == "Pending")
+                return "mission not approved/funded by admin yet";
+            Rng launch = rng_Make(seed);
+            string tag = " (seed " + to_string(seed) + ")";
+            for (int s = 0; s < (int)launchFailure.size(); s++)
+                if (!sim_SystemGo(launch, s))
+                {
+                    flight_SetStatus(missions, i, "Failure");
+                    addLog("Launch Failure: " + names[i] + tag, logs);
+                    cout << "mission " << i + 1 << " failed at " << launchSystems[s] << tag << "\n";
+                    return "";
+                }
+            flight_SetStatus(missions, i, "Success");
+            addLog("Launch Success: " + names[i] + tag, logs);
+            cout << "mission " << i + 1 << " launched" << tag << "\n";
+            return "";
+        }
+        if (sub == "predict" && argc >= 3 && argc <= 5)
+        {
+            double runs = LAUNCH_PREDICT_RUNS;
+            uint64_t seed = rng_Next(rng);
+            if (!batch_Row(words[2], missions, i))
+                return "no mission " + words[2];
+            if ((argc >= 4 && !batch_Number(words[3], 1, (double)MC_MAX_RUNS, runs)) || (argc == 5 && !csv_Field(words[4], seed)))
+                return "usage: mission predict <id> [runs 1-1e10] [seed]";
+            McLaunchResult r = sim_Predict((long long)runs, seed);
+            cout << "mission " << i + 1 << " predicted " << sim_Percent(r.p) << " (95% CI " << sim_Percent(r.lo) << " - " << sim_Percent(r.hi) << ") over " << r.runs << " launches, seed " << seed << "\n";
+            for (size_t s = 0; s < launchFailure.size(); s++)
+                cout << "   " << launchSystems[s] << " lost " << r.failures[s] << " (" << sim_Percent((double)r.failures[s] / max(1LL, r.runs - r.successes)) << " of failures, " << sim_Percent(mc_FailRate(r, s)) << " of launches reaching it)\n";
+            return "";
+        }
+        if (sub == "delete" && argc == 3)
+        {
+            if (!batch_Row(words[2], missions, i))
+                return "no mission " + words[2];
+            flight_RemoveMission(missions, i);
+            return "";
+        }
+        if (sub == "list" && argc <= 3)
+        {
+            for (int r = 0; r < missions.size(); r++)
+                if (table_Live(missions, r) && (argc == 2 || status[r] == words[2]))
+                    cout << r + 1 << "," << missions.col<MissionCode>()[r] << "," << names[r] << "," << status[r] << "," << missions.col<MissionRequester>()[r] << "," << missions.col<MissionCost>()[r] << "\n";
+            return "";
+        }
+        return "unknown mission command";
+    }
+
+    if (cmd == "inventory")
+    {
+        InventoryTable &inv = db.inventory;
+        int i;
+        if (!employee)
+            return "restricted area, engineering access required";
+        if (sub == "add")
+        {
+            double qty, cost;
+            if (argc != 7 || !batch_Number(words[4], 1, 10000, qty) || !batch_Number(words[6], 0.001, 100.0, cost))
+                return "usage: inventory add <name> <category> <qty 1-10000> <unit> <cost 0.001-100>";
+            i = eng_InsertItem(inv, words[2], words[3], qty, words[5], cost);
+            cout << "item " << i + 1 << " added\n";
+            return "";
+        }
+        if (sub == "delete" && argc == 3)
+        {
+            if (!batch_Row(words[2], inv, i))
+                return "no item " + words[2];
+            eng_RemoveItem(inv, i);
+            return "";
+        }
+        if (sub == "list" && argc == 2)
+        {
+            for (int r = 0; r < inv.size(); r++)
+                if (table_Live(inv, r))
+                    cout << r + 1 << "," << inv.col<InvName>()[r] << "," << inv.col<InvCat>()[r] << "," << inv.col<InvQty>()[r] << "," << inv.col<InvUnit>()[r] << "," << inv.col<InvCost>()[r] << "\n";
+            return "";
+        }
+        return "unknown inventory command";
+    }
+
+    if (cmd == "hire")
+    {
+        HireTable &hires = db.hires;
+        Column<string> &hireUsers = hires.col<HireUser>();
+        Column<DictString> &hireStatus = hires.col<HireStatus>();
+        int i;
+        if (!admin)
+            return "admin only";
+        if ((sub == "approve" || sub == "reject") && argc == 3)
+        {
+            vector<int> rows;
+            if (words[2] == "all")
+                rows = rowset_Rows(hiresByStatus, "Pending");
+            else if (batch_Row(words[2], hires, i) && hireStatus[i] == "Pending")
+                rows.push_back(i);
+            else
+                return "no pending application " + words[2];
+            for (int r : rows)
+            {
+                if (sub == "reject")
+                    admin_RejectHire(hires, r);
+                else if (admin_ApproveHire(db.users, hires, db.astronauts, r))
+                    addLog("Hired " + hireUsers[r], logs);
+                else
+                    return "applicant " + hireUsers[r] + " has no account";
+                cout << "application " << r + 1 << (sub == "reject" ? " rejected\n" : " approved\n");
+            }
+            return "";
+        }
+        if (sub == "list" && argc == 2)
+        {
+            for (int r : rowset_Rows(hiresByStatus, "Pending"))
+                cout << r + 1 << "," << hireUsers[r] << "," << hires.col<HireName>()[r] << "," << hires.col<HireEdu>()[r] << "," << hires.col<HireRole>()[r] << "," << hires.col<HireExp>()[r] << "\n";
+            return "";
+        }
+        return "unknown hire command";
+    }
+
+    if (cmd == "planet")
+    {
+        PlanetTable &planets = db.planets;
+        int i;
+        if (sub == "add")
+        {
+            double dist, grav;
+            if (argc != 7 || !batch_Number(words[4], 0.1, 100.0, dist) || !batch_Number(words[5], 0.1, 100.0, grav))
+                return "usage: planet add <name> <type> <distance 0.1-100> <gravity 0.1-100> <atmosphere>";
+            i = sci_InsertPlanet(planets, words[2], words[3], dist, grav, words[6]);
+            cout << "planet " << i + 1 << " cataloged\n";
+            return "";
+        }
+        if (sub == "set" && argc == 5)
+        {
+            double v;
+            if (!batch_Row(words[2], planets, i))
+                return "no planet " + words[2];
+            if ((words[3] == PlanetDist::name || words[3] == PlanetGrav::name) && !batch_Number(words[4], 0.1, 100.0, v))
+                return words[3] + " must be within 0.1-100";
+            if (!batch_SetField(planets, i, words[3], words[4]))
+                return "cannot set " + words[3] + " to " + words[4];
+            journal_Touch(planetsJournal, i);
+            return "";
+        }
+        if (sub == "delete" && argc == 3)
+        {
+            if (!batch_Row(words[2], planets, i))
+                return "no planet " + words[2];
+            sci_RemovePlanet(planets, i);
+            return "";
+        }
+        if (sub == "list" && argc == 2)
+        {
+            for (int r = 0; r < planets.size(); r++)
+                if (table_Live(planets, r))
+                    cout << r + 1 << "," << planets.col<PlanetName>()[r] << "," << planets.col<PlanetType>()[r] << "," << planets.col<PlanetDist>()[r] << "," << planets.col<PlanetGrav>()[r] << "," << planets.col<PlanetAtm>()[r] << "\n";
+            return "";
+        }
+        return "unknown planet command";
+    }
+
+    if (cmd == "query")
+    {
+        Query q;
+        QueryResult res;
+        string error;
+        if (!query_Parse(words, 1, q, error) || !runQuery(db, role, q, res, error))
+            return error;
+        vector<string> cells;
+        for (long long k = -1; k < query_Count(res); k++)
+        {
+            if (k < 0)
+                cells = res.header;
+            else
+                query_Cells(res, k, cells);
+            for (size_t c = 0; c < cells.size(); c++)
+                cout << (c ? "," : "") << cells[c];
+            cout << "\n";
+        }
+        return "";
+    }
+
+    if (cmd == "dock")
+    {
+        DockState st;
+        double v[4] = {0, 0, 0, 0};
+        bool ok = (argc >= 3 && argc <= 5);
+        for (size_t k = 1; ok && k < argc; k++)
+            ok = batch_Number(words[k], k <= 2 ? -2000 : -10, k <= 2 ? 2000 : 10, v[k - 1]);
+        if (!ok)
+            return "usage: dock <radial m> <along-track m> [radial m/s] [along-track m/s]";
+        st.x = v[0];
+        st.y = v[1];
+        st.vx = v[2];
+        st.vy = v[3];
+        DockLanes lanes;
+        DockPlan plan = sim_PlanDocking(st, lanes);
+        if (!plan.found)
+            return "no approach found";
+        cout << "approach " << plan.fuel << " m/s: coast " << plan.coast * dockModel.dt << " s, burn " << plan.dv1x << "," << plan.dv1y
+             << " m/s, transfer " << plan.transfer * dockModel.dt << " s, burn " << plan.dv2x << "," << plan.dv2y << " m/s, miss " << plan.miss
+             << " m (" << plan.evaluated << " trajectories, " << plan.ms << " ms)\n";
+        return "";
+    }
+
+    if (cmd == "import")
+    {
+        ImportResult res;
+        if (argc != 3)
+            return "usage: import <inventory|astronauts|exoplanets> <file>";
+        if (sub == "inventory")
+        {
+            if (!employee)
+                return "restricted area, engineering access required";
+            res = eng_ImportItems(db.inventory, words[2]);
+        }
+        else if (sub == "astronauts")
+        {
+            if (!admin)
+                return "admin only";
+            res = hr_ImportAstronauts(db.astronauts, words[2]);
+        }
+        else if (sub == "exoplanets")
+            res = sci_ImportExoplanets(db.exoplanets, words[2]);
+        else
+            return "unknown import table " + sub;
+        if (!res.opened)
+            return "cannot read " + words[2];
+        addLog("Imported " + to_string(res.accepted) + " " + sub + " from " + words[2], logs);
+        cout << res.accepted << " " << sub << " imported, " << res.rejected << " rejected";
+        if (res.rejected > 0)
+            cout << " (see " << words[2] << ".rejects.csv)";
+        cout << "\n";
+        return "";
+    }
+    return "unknown command " + cmd;
+}
+
+// Bulk Import
+// Each reads a CSV file laid out like its table (the first line may be the column labels),
+// checks every row against the same ranges as the menus and appends the accepted rows once
+// the whole file has been read. Rejected rows are listed in <path>.rejects.csv. Saving is
+// left to the caller, like the record operations.
+ImportResult eng_ImportItems(InventoryTable &inv, string path)
+{
+    struct Item
+    {
+        string name, cat, unit;
+        double qty = 0, cost = 0;
+    };
+    vector<Item> items;
+    ImportResult res = import_Csv(path, path + ".rejects.csv", import_Header(inv), 5, [](const string_view *f, Item &it) -> const char *
+                                  {
+                                      if (!importText(f[0], it.name))
+                                          return "empty name";
+                                      if (!importText(f[1], it.cat))
+                                          return "empty category";
+                                      if (!import_Number(f[2], 1, 10000, it.qty))
+                                          return "quantity not within 1-10000";
+                                      if (!importText(f[3], it.unit))
+                                          return "empty unit";
+                                      if (!import_Number(f[4], 0.001, 100.0, it.cost))
+                                          return "cost not within 0.001-100";
+                                      return nullptr; },
+                                  items);
+    for (Item &it : items)
+        eng_InsertItem(inv, move(it.name), move(it.cat), it.qty, move(it.unit), it.cost);
+    return res;
+}
+ImportResult hr_ImportAstronauts(AstroTable &astros, string path)
+{
+    struct Astronaut
+    {
+        string name, rank, status;
+    };
+    vector<Astronaut> crew;
+    ImportResult res = import_Csv(path, path + ".rejects.csv", import_Header(astros), 3, [](const string_view *f, Astronaut &a) -> const char *
+                                  {
+                                      if (!importText(f[0], a.name))
+                                          return "empty name";
+                                      if (!importText(f[1], a.rank))
+                                          return "empty rank";
+                                      if (!importText(f[2], a.status))
+                                          return "empty status";
+                                      return nullptr; },
+                                  crew);
+    for (Astronaut &a : crew)
+        hr_InsertAstronaut(astros, move(a.name), move(a.rank), move(a.status));
+    return res;
+}
+ImportResult sci_ImportExoplanets(ExoplanetTable &exos, string path)
+{
+    struct Exoplanet
+    {
+        string name, type;
+        double dist = 0;
+        bool habitable = false;
+    };
+    vector<Exoplanet> found;
+    ImportResult res = import_Csv(path, path + ".rejects.csv", import_Header(exos), 4, [](const string_view *f, Exoplanet &e) -> const char *
+                                  {
+                                      if (!importText(f[0], e.name))
+                                          return "empty name";
+                                      if (!import_Number(f[1], 1.0, 10000.0, e.dist))
+                                          return "distance not within 1-10000";
+                                      if (!importText(f[2], e.type))
+                                          return "empty type";
+                                      if (!csv_Field(f[3], e.habitable))
+                                          return "habitable not 0 or 1";
+                                      return nullptr; },
+                                  found);
+    for (Exoplanet &e : found)
+        sci_InsertExoplanet(exos, move(e.name), e.dist, move(e.type), e.habitable);
+    return res;
+}
+// A text field as getInput would store it, false when it is empty
+bool importText(string_view field, string &out)
+{
+    out = cleanField(string(field));
+    return !out.empty();
+}
+
+// Benchmarks
+// Times a cold start of an inventory-shaped table of the given size, CSV parsing against the snapshot
+void bench_Boot(int rows)
+{
+    using namespace chrono;
+    string cats[] = {"Propulsion", "Structure", "Power", "Electronics", "Robotics", "Science"};
+    string units[] = {"kg", "box", "pcs"};
+
+    // Synthetic data set written in both formats
+    vector<string> names(rows), cat(rows), unit(rows);
+    vector<double> qtys(rows), costs(rows);
+    for (int i = 0; i < rows; i++)
+    {
+        names[i] = "Component-" + to_string(i);
+        cat[i] = cats[i % 6];
+        unit[i] = units[i % 3];
+        qtys[i] = 1 + i % 10000;
+        costs[i] = 0.001 * (1 + i % 100000);
+    }
+    Journal j("bench_inv.csv", 1);
+    journal_Save(j, to_string(rows), rows, [&](int i)
+                 {
+                     ostringstream row;
+                     row << names[i] << "," << cat[i] << "," << qtys[i] << "," << unit[i] << "," << costs[i];
+                     return row.str(); });
+    journal_Wait(j);
+
+    SnapshotWriter w;
+    snap_Table(w, "inventory", rows, journal_Stamp(j));
+    snap_Strings(w, names.data());
+    snap_Strings(w, cat.data());
+    snap_Doubles(w, qtys.data());
+    snap_Strings(w, unit.data());
+    snap_Doubles(w, costs.data());
+    snap_Write(w, "bench_snapshot.bin");
+
+    // CSV boot, same parsing as loadInventory
+    vector<string> n2(rows), c2(rows), u2(rows);
+    vector<double> q2(rows), k2(rows);
+    auto t0 = steady_clock::now();
+    Journal r("bench_inv.csv", 1);
+    CsvData data;
+    journal_Load(r, data);
+    csv_Parse(data, rows, r.errors, r.tombstones, n2, c2, q2, u2, k2);
+    auto t1 = steady_clock::now();
+
+    // Snapshot boot: map and validate, then copy the columns out
+    SnapshotFile snap;
+    SnapTable t;
+    bool ok = snap_Open(snap, "bench_snapshot.bin") && snap_Find(snap, "inventory", t);
+    auto t2 = steady_clock::now();
+    if (ok)
+    {
+        const SnapStr *sn = snap_StringColumn(snap, t, 0), *sc = snap_StringColumn(snap, t, 1), *su = snap_StringColumn(snap, t, 3);
+        const double *sq = snap_DoubleColumn(snap, t, 2), *sk = snap_DoubleColumn(snap, t, 4);
+        for (uint64_t i = 0; i < t.rows; i++)
+        {
+            n2[i] = string(snap_String(snap, sn[i]));
+            c2[i] = string(snap_String(snap, sc[i]));
+            q2[i] = sq[i];
+            u2[i] = string(snap_String(snap, su[i]));
+            k2[i] = sk[i];
+        }
+    }
+    auto t3 = steady_clock::now();
+    snap_Close(snap);
+
+    auto ms = [](steady_clock::duration d)
+    { return duration<double, milli>(d).count(); };
+    cout << fixed << setprecision(1);
+    cout << "Rows:                     " << rows << "\n";
+    double mb = (double)filesystem::file_size("bench_inv.csv") / (1024.0 * 1024.0);
+    cout << "CSV parse:                " << ms(t1 - t0) << " ms (" << mb / (ms(t1 - t0) / 1000.0) << " MB/s)\n";
+    cout << "Snapshot map + validate:  " << (ok ? ms(t2 - t1) : 0.0) << " ms" << (ok ? "" : " (FAILED)") << "\n";
+    cout << "Snapshot map + copy out:  " << (ok ? ms(t3 - t1) : 0.0) << " ms\n";
+
+    remove("bench_inv.csv");
+    remove(journal_DeltaPath(j, j.epoch).c_str());
+    remove("bench_snapshot.bin");
+}
+// Resident memory of this process in bytes
+size_t processMemory()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+    return pmc.WorkingSetSize;
+#else
+    // Second field of statm is the resident set in pages
+    long long pages = 0, resident = 0;
+    ifstream statm("/proc/self/statm");
+    if (!(statm >> pages >> resident))
+        return 0;
+    return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+// Grows an inventory table to maxRows and reports resident memory at every power of ten
+void bench_Memory(int maxRows)
+{
+    string cats[] = {"Propulsion", "Structure", "Power", "Electronics", "Robotics", "Science"};
+    string units[] = {"kg", "box", "pcs"};
+
+    size_t base = processMemory();
+    InventoryTable inv;
+    Column<string> &names = inv.col<InvName>();
+    Column<DictString> &cat = inv.col<InvCat>();
+    Column<double> &qty = inv.col<InvQty>();
+    Column<DictString> &unit = inv.col<InvUnit>();
+    Column<double> &cost = inv.col<InvCost>();
+    const double *first = nullptr;
+    bool moved = false;
+
+    cout << fixed << setprecision(1);
+    cout << setw(12) << "Rows" << setw(14) << "RSS (MB)" << setw(14) << "Bytes/row" << "\n";
+    for (int next = 1000; inv.size() < maxRows; next = (next > maxRows / 10 ? maxRows : next * 10))
+    {
+        while (inv.size() < min(next, maxRows))
+        {
+            int r = table_Append(inv);
+            names[r] = "Component-" + to_string(r);
+            cat[r] = cats[r % 6];
+            qty[r] = 1 + r % 10000;
+            unit[r] = units[r % 3];
+            cost[r] = 0.001 * (1 + r % 100000);
+            if (r == 0)
+                first = &qty[0];
+        }
+        moved = moved || (first != &qty[0]);
+        size_t rss = processMemory();
+        double perRow = rss > base ? (double)(rss - base) / inv.size() : 0.0;
+        cout << setw(12) << inv.size() << setw(14) << rss / (1024.0 * 1024.0) << setw(14) << perRow << "\n";
+    }
+    cout << "Row 0 stayed in place while growing: " << (moved ? "no" : "yes") << "\n";
+}
+// Times signIn and the signUp name check against user tables of growing size
+void bench_Login(int maxRows)
+{
+    using namespace chrono;
+    const int lookups = 100000;
+    UserTable users;
+    Column<string> &usernames = users.col<UserName>();
+    Column<string> &passwords = users.col<UserPassword>();
+    LogStore logs;
+
+    cout << fixed << setprecision(3);
+    cout << setw(12) << "Users" << setw(16) << "signIn (us)" << setw(16) << "free name (us)" << setw(16) << "scan (us)" << "\n";
+    for (int next = 1000; users.size() < maxRows; next = (next > maxRows / 10 ? maxRows : next * 10))
+    {
+        while (users.size() < min(next, maxRows))
+        {
+            int r = table_Append(users);
+            usernames[r] = "user" + to_string(r);
+            passwords[r] = "Password" + to_string(r);
+        }
+        index_Build(userIndex, usernames);
+        int n = users.size();
+
+        // Existing accounts with the right password
+        int hits = 0;
+        auto t0 = steady_clock::now();
+        for (int i = 0; i < lookups; i++)
+        {
+            int r = (int)((i * 2654435761u) % (unsigned)n);
+            hits += (signIn("user" + to_string(r), "Password" + to_string(r), users, logs) == r);
+        }
+        auto t1 = steady_clock::now();
+        // Names nobody has, as a new signUp would check them
+        int taken = 0;
+        for (int i = 0; i < lookups; i++)
+            taken += (index_Find(userIndex, usernames, "new" + to_string(i)) >= 0);
+        auto t2 = steady_clock::now();
+        // The linear scan signIn used to do, for comparison
+        int scans = max(1, min(lookups, 100000000 / n));
+        for (int i = 0; i < scans; i++)
+        {
+            string name = "user" + to_string((int)((i * 2654435761u) % (unsigned)n));
+            for (int k = 0; k < n; k++)
+                if (usernames[k] == name)
+                {
+                    hits++;
+                    break;
+                }
+        }
+        auto t3 = steady_clock::now();
+
+        auto us = [](steady_clock::duration d, int count)
+        { return duration<double, micro>(d).count() / count; };
+        cout << setw(12) << n << setw(16) << us(t1 - t0, lookups) << setw(16) << us(t2 - t1, lookups) << setw(16) << us(t3 - t2, scans);
+        if (hits < lookups || taken > 0)
+            cout << "  (lookup mismatch)";
+        cout << "\n";
+    }
+}
+// Times deleting half of an inventory table in random order, compaction included
+void bench_Delete(int maxRows)
+{
+    using namespace chrono;
+    cout << fixed << setprecision(3);
+    cout << setw(12) << "Rows" << setw(12) << "Deletes" << setw(14) << "Total (ms)" << setw(16) << "Per delete (us)" << setw(12) << "Rows left" << "\n";
+    for (int n = 1000; n <= maxRows; n = (n < maxRows && n > maxRows / 10 ? maxRows : n * 10))
+    {
+        InventoryTable inv;
+        Column<string> &names = inv.col<InvName>();
+        for (int r = 0; r < n; r++)
+            names[table_Append(inv)] = "Component-" + to_string(r);
+        // Journal that is never saved, it only tracks the records a save would write
+        Journal j("bench_delete.csv", 1);
+        vector<int> order(n);
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+        Rng shuffle = rng_Make(n);
+        for (int i = n - 1; i > 0; i--)
+            swap(order[i], order[rng_Below(shuffle, i + 1)]);
+
+        int deletes = n / 2;
+        auto t0 = steady_clock::now();
+        for (int d = 0; d < deletes; d++)
+        {
+            int r = order[d];
+            table_Kill(inv, r);
+            journal_Touch(j, r);
+            compactTable(inv, j);
+        }
+        auto t1 = steady_clock::now();
+        double ms = duration<double, milli>(t1 - t0).count();
+        cout << setw(12) << n << setw(12) << deletes << setw(14) << ms << setw(16) << ms * 1000.0 / deletes << setw(12) << inv.size() << "\n";
+        if (n == maxRows)
+            break;
+    }
+}
+// Times composing and flushing frames of a 200x100 grid, a few moving sprites and a full repaint
+void bench_Render(int frames)
+{
+    using namespace chrono;
+    const int W = 200, H = 100, sprites = 8;
+    FrameBuffer fb;
+    frame_Init(fb, W, H);
+    // Written to memory, so the numbers leave out the time the terminal takes to draw
+    ostringstream screen;
+
+    cout << fixed << setprecision(4);
+    cout << "Grid " << W << "x" << H << ", " << frames << " frames per scene\n";
+    cout << setw(10) << "Scene" << setw(14) << "Avg (ms)" << setw(14) << "Max (ms)" << setw(14) << "Compose (ms)" << setw(14) << "Flush (ms)" << setw(12) << "Cells" << setw(12) << "Bytes" << "\n";
+    for (int scene = 0; scene < 2; scene++)
+    {
+        double compose = 0, flush = 0, maxMs = 0;
+        long long cells = 0, bytes = 0;
+        frame_Invalidate(fb);
+        for (int f = 0; f <= frames; f++)
+        {
+            screen.str(string());
+            frame_Clear(fb);
+            for (int y = 0; y < H; y++)
+                for (int x = 0; x < W; x++)
+                {
+                    if (scene == 0)
+                        frame_Put(fb, x, y, (x == 0 || y == 0 || x == W - 1 || y == H - 1) ? '#' : '.', FC_GRAY);
+                    else
+                        frame_Put(fb, x, y, (char)('a' + (x + y + f) % 26), (uint8_t)(31 + (x + f) % 7));
+                }
+            if (scene == 0)
+                for (int s = 0; s < sprites; s++)
+                {
+                    int x = 1 + (s * 23 + f) % (W - 2), y = 1 + (s * 11 + f / 3) % (H - 2);
+                    frame_Put(fb, x, y, 'R', FC_CYAN);
+                }
+            frame_Text(fb, 2, 0, " frame " + to_string(f) + " ", FC_WHITE);
+            frame_Flush(fb, screen);
+            // The first frame is a full draw of an unknown screen, leave it out of the averages
+            if (f == 0)
+                continue;
+            compose += fb.stats.composeMs;
+            flush += fb.stats.flushMs;
+            maxMs = max(maxMs, fb.stats.frameMs);
+            cells += fb.stats.cells;
+            bytes += fb.stats.bytes;
+        }
+        int n = max(1, frames);
+        cout << setw(10) << (scene == 0 ? "sprites" : "repaint") << setw(14) << (compose + flush) / n << setw(14) << maxMs << setw(14) << compose / n << setw(14) << flush / n << setw(12) << cells / n << setw(12) << bytes / n << "\n";
+    }
+
+    // The old loops: one stream write per cell after clearing the screen
+    double old = 0;
+    long long oldBytes = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        screen.str(string());
+        auto t0 = steady_clock::now();
+        screen << "\033[2J\033[H";
+        for (int y = 0; y < H; y++)
+        {
+            for (int x = 0; x < W; x++)
+                screen << GRA << '.' << RST;
+            screen << endl;
+        }
+        old += duration<double, milli>(steady_clock::now() - t0).count();
+        oldBytes += (long long)screen.tellp();
+    }
+    cout << setw(10) << "per-cell" << setw(14) << old / max(1, frames) << setw(14) << "" << setw(14) << "" << setw(14) << "" << setw(12) << W * H << setw(12) << oldBytes / max(1, frames) << "\n";
+    cout << "(per-cell is the old redraw without the cls process it also started every frame)\n";
+}
+// Times paging through an inventory view of growing size against printing the whole table
+void bench_Pager(int maxRows)
+{
+    using namespace chrono;
+    const int pages = 200;
+    cout << fixed << setprecision(4);
+    cout << setw(10) << "Rows" << setw(16) << "Page (ms)" << setw(16) << "Scroll (ms)" << setw(16) << "Print all (ms)" << "\n";
+    for (int rows = 1000; rows <= maxRows; rows *= 10)
+    {
+        InventoryTable inv;
+        table_Resize(inv, rows);
+        for (int i = 0; i < rows; i++)
+        {
+            auto item = inv[i];
+            item.get<InvName>() = "Part-" + to_string(i);
+            item.get<InvCat>() = "Structure";
+            item.get<InvQty>() = i % 10000;
+            item.get<InvUnit>() = "pcs";
+            item.get<InvCost>() = 0.5 + i % 50;
+        }
+        Column<string> &names = inv.col<InvName>();
+        Column<DictString> &cats = inv.col<InvCat>();
+        Column<double> &qtys = inv.col<InvQty>();
+        Column<double> &costs = inv.col<InvCost>();
+        vector<int> live = liveRows(inv);
+        auto row = [&](long long p, PagerRow &r)
+        {
+            int i = live[p];
+            r.cells[0] = to_string(i + 1);
+            r.cells[1] = names[i];
+            r.cells[2] = cats[i];
+            r.cells[3] = formatNumber(qtys[i]);
+            r.cells[4] = "$" + formatNumber(costs[i]);
+        };
+        PagerView view;
+        for (const char *c : {"ID", "ITEM", "CAT", "QTY", "COST"})
+            pager_Column(view, c, 30);
+        FrameBuffer fb;
+        frame_Init(fb, 100, 36);
+        ostringstream screen;
+
+        // Page Down through the table, then one line at a time
+        double page = 0, scroll = 0;
+        pager_Draw(fb, view, rows, row, "");
+        frame_Flush(fb, screen);
+        for (int k = 0; k < pages; k++)
+        {
+            pager_Key(view, TERM_KEY_PGDN, rows);
+            pager_Draw(fb, view, rows, row, "");
+            frame_Flush(fb, screen);
+            page += fb.stats.frameMs;
+        }
+        for (int k = 0; k < pages; k++)
+        {
+            pager_Key(view, TERM_KEY_DOWN, rows);
+            pager_Draw(fb, view, rows, row, "");
+            frame_Flush(fb, screen);
+            scroll += fb.stats.frameMs;
+        }
+
+        // The old view: every row formatted with setw and written out
+        screen.str(string());
+        auto t0 = steady_clock::now();
+        for (int i = 0; i < rows; i++)
+            screen << left << setw(5) << i + 1 << setw(30) << names[i] << setw(12) << cats[i] << setw(8) << qtys[i] << "$" << costs[i] << "\n";
+        double all = duration<double, milli>(steady_clock::now() - t0).count();
+        cout << setw(10) << rows << setw(16) << page / pages << setw(16) << scroll / pages << setw(16) << all << "\n";
+    }
+}
+// Times the rollup kernels (see rollup.h) on inventory-shaped columns, scalar against AVX2
+void bench_Rollup(int rows)
+{
+    using namespace chrono;
+    const int runs = 5;
+    string cats[] = {"Propulsion", "Structure", "Power", "Electronics", "Robotics", "Science"};
+    Column<double> qtys, costs;
+    Column<DictString> cat;
+    qtys.resize(rows);
+    costs.resize(rows);
+    cat.resize(rows);
+    DictCode codes[6];
+    for (int k = 0; k < 6; k++)
+        codes[k] = dict_Intern(cat.dict, cats[k]);
+    for (int i = 0; i < rows; i++)
+    {
+        qtys[i] = 1 + i % 10000;
+        costs[i] = 0.001 + (i % 1000) * 0.1;
+        cat.codes[i] = codes[(i / 7) % 6];
+    }
+
+    bool avx2 = rollup_HasAvx2();
+    cout << fixed << setprecision(3);
+    cout << rows << " rows, AVX2 " << (avx2 ? "available" : "not available, scalar only") << ", best of " << runs << " runs\n";
+    cout << setw(22) << "Rollup" << setw(14) << "Scalar (ms)" << setw(14) << "AVX2 (ms)" << setw(12) << "Speedup" << setw(12) << "GB/s" << "  Result\n";
+    auto time = [&](auto fn, double &out)
+    {
+        double best = 1e300;
+        for (int r = 0; r < runs; r++)
+        {
+            auto t0 = steady_clock::now();
+            out = fn();
+            best = min(best, duration<double, milli>(steady_clock::now() - t0).count());
+        }
+        return best;
+    };
+    auto report = [&](const char *name, double bytes, auto fn)
+    {
+        double scalarOut = 0, simdOut = 0;
+        double scalar = time([&]()
+                             { return fn(false); }, scalarOut);
+        double simd = avx2 ? time([&]()
+                                  { return fn(true); }, simdOut)
+                           : 0;
+        cout << setw(22) << name << setw(14) << scalar;
+        if (avx2)
+            cout << setw(14) << simd << setw(11) << scalar / simd << "x" << setw(12) << bytes / (simd * 1e6);
+        else
+            cout << setw(14) << "-" << setw(12) << "-" << setw(12) << bytes / (scalar * 1e6);
+        cout << "  " << setprecision(6) << scientific << scalarOut << ((!avx2 || simdOut == scalarOut) ? "" : " MISMATCH") << fixed << setprecision(3) << "\n";
+    };
+    double n = rows;
+    report("sum(quantity)", n * 8, [&](bool simd)
+           { return rollup_Sum(qtys, simd); });
+    report("sum(quantity*cost)", n * 16, [&](bool simd)
+           { return rollup_Dot(qtys, &costs, simd); });
+    report("by category", n * 20, [&](bool simd)
+           {
+               vector<RollupGroup> g = rollup_GroupDot(cat, qtys, &costs, simd);
+               return g[codes[0]].sum; });
+
+    // The loop the dashboards would otherwise run: one row at a time through the column
+    auto t0 = steady_clock::now();
+    double total = 0;
+    for (int i = 0; i < rows; i++)
+        total += qtys[i] * costs[i];
+    cout << "per-row loop sum(quantity*cost): " << duration<double, milli>(steady_clock::now() - t0).count() << " ms (" << setprecision(6) << scientific << total << fixed << setprecision(3) << ")\n";
+}
+// Times the Monte Carlo launch runs (see montecarlo.h) on one thread and on all of them
+void bench_Launch(long long runs)
+{
+    using namespace chrono;
+    const uint64_t seed = 20260729;
+    cout << fixed << setprecision(3);
+    cout << runs << " launches of " << launchFailure.size() << " subsystems, seed " << seed << "\n";
+    cout << setw(10) << "Threads" << setw(14) << "Time (ms)" << setw(18) << "Launches/s" << setw(12) << "Success" << "  95% CI\n";
+    McLaunchResult first;
+    for (int threads : {1, parallel_Threads(1 << 30, 64)})
+    {
+        McLaunchResult r = mc_Launch(launchFailure, runs, seed, threads);
+        cout << setw(10) << r.threads << setw(14) << r.ms << setw(18) << setprecision(0) << r.runs / (r.ms / 1000) << setprecision(3)
+             << setw(12) << sim_Percent(r.p) << "  " << sim_Percent(r.lo) << " - " << sim_Percent(r.hi);
+        if (first.runs == 0)
+            first = r;
+        else if (r.successes != first.successes || r.failures != first.failures)
+            cout << "  MISMATCH";
+        cout << "\n";
+    }
+    for (size_t s = 0; s < launchFailure.size(); s++)
+        cout << "   " << left << setw(10) << launchSystems[s] << right << setw(14) << first.failures[s] << " lost, " << sim_Percent(mc_FailRate(first, s)) << " of launches reaching it\n";
+
+    // The interactive sequence without its pauses, one launch at a time on one stream
+    long long sample = min(runs, 10000000LL), ok = 0;
+    Rng r = rng_Make(seed);
+    auto t0 = steady_clock::now();
+    for (long long i = 0; i < sample; i++)
+    {
+        int s = 0;
+        while (s < (int)launchFailure.size() && sim_SystemGo(r, s))
+            s++;
+        ok += (s == (int)launchFailure.size());
+    }
+    double ms = duration<double, milli>(steady_clock::now() - t0).count();
+    cout << "sim_SystemGo loop: " << sample << " launches in " << ms << " ms, " << setprecision(0) << sample / (ms / 1000) << " launches/s, success " << sim_Percent((double)ok / sample) << "\n";
+}
+// Times the docking integrator (see docking.h): lanes flown together against one trajectory
+// at a time, then the autopilot planner from a few starting points
+void bench_Docking(int trajectories)
+{
+    using namespace chrono;
+    const int steps = 2400; // 20 minutes of flight
+    int n = max(1, trajectories);
+    DockLanes lanes;
+    Rng r = rng_Make(n);
+    lanes.steps.assign(n, steps);
+    for (int i = 0; i < n; i++)
+    {
+        lanes.x.push_back((double)rng_Below(r, 201) - 100);
+        lanes.y.push_back(-(double)rng_Below(r, 1001));
+        lanes.vx.push_back(0);
+        lanes.vy.push_back(0);
+    }
+    vector<DockState> one(n);
+    for (int i = 0; i < n; i++)
+    {
+        one[i].x = lanes.x[i];
+        one[i].y = lanes.y[i];
+    }
+
+    cout << fixed << setprecision(3);
+    cout << n << " trajectories of " << steps << " steps (" << steps * dockModel.dt << " s of flight)\n";
+    auto t0 = steady_clock::now();
+    for (DockState &st : one)
+        for (int k = 0; k < steps; k++)
+            dock_Step(dockModel, st);
+    double single = duration<double, milli>(steady_clock::now() - t0).count();
+    auto match = [&](const DockLanes &l)
+    {
+        for (int i = 0; i < n; i++)
+            if (one[i].x != l.x[i] || one[i].y != l.y[i] || one[i].vx != l.vx[i] || one[i].vy != l.vy[i])
+                return "  MISMATCH";
+        return "";
+    };
+    long long taken = (long long)n * steps;
+    cout << setw(16) << "one at a time" << setw(12) << single << " ms" << setw(10) << setprecision(1) << taken / (single * 1000) << " M steps/s\n" << setprecision(3);
+    for (bool simd : {false, true})
+    {
+        if (simd && !rollup_HasAvx2())
+            break;
+        DockLanes l = lanes;
+        t0 = steady_clock::now();
+        dock_Fly(dockModel, l, simd);
+        double ms = duration<double, milli>(steady_clock::now() - t0).count();
+        cout << setw(16) << (simd ? "lanes, AVX2" : "lanes, scalar") << setw(12) << ms << " ms" << setw(10) << setprecision(1) << taken / (ms * 1000) << " M steps/s" << setprecision(3) << match(l) << "\n";
+    }
+
+    // The autopilot, planned and then flown step by step to check it arrives
+    cout << setw(18) << "Start (m)" << setw(12) << "Plan (ms)" << setw(14) << "Candidates" << setw(12) << "dv (m/s)" << setw(14) << "Arrival (s)" << setw(16) << "Docked at (m)\n";
+    DockState starts[] = {{-50, -300, 0, 0}, {60, -400, 0, 0}, {0, -1000, 0, 0}, {-100, 200, 0.1, 0}, {20, -150, 0, 0.2}};
+    DockLanes scratch;
+    for (const DockState &st : starts)
+    {
+        DockPlan plan = sim_PlanDocking(st, scratch);
+        DockState fly = st;
+        for (int k = 0; k < plan.coast; k++)
+            dock_Step(dockModel, fly);
+        fly.vx += plan.dv1x;
+        fly.vy += plan.dv1y;
+        for (int k = 0; k < plan.transfer; k++)
+            dock_Step(dockModel, fly);
+        ostringstream at;
+        at << "(" << (int)st.x << "," << (int)st.y << ")";
+        cout << setw(18) << at.str() << setw(12) << plan.ms << setw(14) << plan.evaluated << setw(12) << plan.fuel << setw(14) << (plan.coast + plan.transfer) * dockModel.dt << setw(15) << hypot(fly.x, fly.y) << (plan.found ? "" : "  (none found)") << "\n";
+    }
+}
+// Times A* against jump-point search (see pathfind.h) on a size x size crater field: long
+// routes across the map, then the short hops an autopilot asks for
+void bench_Path(int size)
+{
+    using namespace chrono;
+    size = max(16, size);
+    Rng r = rng_Make(size);
+    PathGrid grid;
+    path_Init(grid, size, size);
+    // Round craters until about a fifth of the ground is covered
+    long long blocked = 0, target = (long long)size * size / 5;
+    while (blocked < target)
+    {
+        int cx = rng_Below(r, size), cy = rng_Below(r, size), rad = 1 + rng_Below(r, 12);
+        for (int y = max(0, cy - rad); y <= min(size - 1, cy + rad); y++)
+            for (int x = max(0, cx - rad); x <= min(size - 1, cx + rad); x++)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= rad * rad && path_Free(grid, x, y))
+                {
+                    path_Set(grid, x, y, true);
+                    blocked++;
+                }
+    }
+    auto freeCell = [&](int x0, int y0, int reach)
+    {
+        PathPoint p;
+        do
+        {
+            p.x = x0 + (int)rng_Below(r, 2 * reach + 1) - reach;
+            p.y = y0 + (int)rng_Below(r, 2 * reach + 1) - reach;
+        } while (!path_Free(grid, p.x, p.y));
+        return p;
+    };
+
+    cout << fixed << setprecision(3);
+    cout << size << " x " << size << " map, " << blocked * 100 / ((long long)size * size) << "% blocked, grid " << (grid.rows.bits.size() + grid.cols.bits.size()) * 8 / 1024 << " KiB\n";
+    cout << setw(8) << "Routes" << setw(8) << "Reach" << setw(10) << "Search" << setw(14) << "Per route" << setw(14) << "Routes/s" << setw(14) << "Nodes" << setw(8) << "Found" << "\n";
+    PathSearch search;
+    PathResult res;
+    for (int reach : {32, size / 2})
+    {
+        int routes = (reach == 32 ? 2000 : 20);
+        vector<pair<PathPoint, PathPoint>> queries;
+        for (int k = 0; k < routes; k++)
+        {
+            PathPoint a = freeCell(size / 2, size / 2, size / 2 - 1);
+            queries.push_back({a, freeCell(a.x, a.y, reach)});
+        }
+        vector<double> cost[2];
+        for (int jps = 0; jps < 2; jps++)
+        {
+            long long nodes = 0, found = 0;
+            auto t0 = steady_clock::now();
+            for (auto &q : queries)
+            {
+                bool ok = jps ? path_Jps(grid, q.first, q.second, search, res) : path_AStar(grid, q.first, q.second, search, res);
+                nodes += res.expanded;
+                found += ok;
+                cost[jps].push_back(ok ? res.cost : -1);
+            }
+            double ms = duration<double, milli>(steady_clock::now() - t0).count();
+            cout << setw(8) << routes << setw(8) << reach << setw(10) << (jps ? "JPS" : "A*") << setw(11) << ms / routes << " ms" << setw(14) << setprecision(0) << routes / (ms / 1000) << setw(14) << nodes / routes << setprecision(3) << setw(8) << found;
+            int mismatches = 0;
+            for (int k = 0; jps && k < routes; k++)
+                mismatches += fabs(cost[0][k] - cost[1][k]) > 1e-6;
+            cout << (mismatches ? "  " + to_string(mismatches) + " LENGTH MISMATCHES" : "") << "\n";
+        }
+    }
 }
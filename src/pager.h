@@ -0,0 +1,149 @@
+/**
+ * @file pager.h
+ * @brief Virtualized, paginated table views drawn through the diff renderer.
+ *
+ * @details
+ * A PagerView shows a window of a table that may hold any number of rows. Only the rows
+ * inside the window are asked for and formatted, so drawing a page costs the same for a
+ * table of ten rows as for one of ten million. Rows are addressed by their position in
+ * the view (0 to count - 1); the caller maps a position to a record.
+ *
+ * Column widths are cached in the view: a column starts as wide as its title and grows to
+ * fit the widest cell it has shown, up to its limit. The view is normally kept for the life
+ * of the program, so later pages and later visits keep the same layout without scanning
+ * the table to measure it.
+ *
+ * The page is composed into a FrameBuffer, so scrolling by a line or a page writes only
+ * the cells that changed (see render.h).
+ */
+
+#ifndef NMS_PAGER_H
+#define NMS_PAGER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "render.h"
+#include "terminal.h"
+
+struct PagerColumn
+{
+    std::string title;
+    int width = 0;     // Cached width, only ever grows
+    int maxWidth = 0;  // Longer cells are cut
+};
+
+// One row as handed to the view, the row callback fills in a cell and a colour per column
+struct PagerRow
+{
+    std::vector<std::string> cells;
+    std::vector<std::uint8_t> colors;
+};
+
+struct PagerView
+{
+    std::string title;
+    std::uint8_t titleColor = FC_YELLOW;
+    std::vector<PagerColumn> columns;
+    long long top = 0;  // Position of the first row on the page
+    int height = 0;     // Rows on a page, set by pager_Draw from the frame
+    std::vector<PagerRow> page; // Rows of the last page drawn, kept to reuse their buffers
+};
+
+// Lines of the frame the page does not use for rows: title, header, rule, gap and two footer lines
+const int PAGER_CHROME = 6;
+
+inline void pager_Column(PagerView &v, const std::string &title, int maxWidth)
+{
+    PagerColumn c;
+    c.title = title;
+    c.width = (int)title.size();
+    c.maxWidth = std::max(maxWidth, c.width);
+    v.columns.push_back(c);
+}
+
+// Keeps the page inside [0, count)
+inline void pager_Clamp(PagerView &v, long long count)
+{
+    v.top = std::min(v.top, count - v.height);
+    v.top = std::max(v.top, 0LL);
+}
+
+// Moves the page for a navigation key, false when the key is not one
+inline bool pager_Key(PagerView &v, int key, long long count)
+{
+    if (key == TERM_KEY_PGDN || key == ' ')
+        v.top += v.height;
+    else if (key == TERM_KEY_PGUP)
+        v.top -= v.height;
+    else if (key == TERM_KEY_DOWN)
+        v.top++;
+    else if (key == TERM_KEY_UP)
+        v.top--;
+    else if (key == TERM_KEY_HOME)
+        v.top = 0;
+    else if (key == TERM_KEY_END)
+        v.top = count;
+    else
+        return false;
+    pager_Clamp(v, count);
+    return true;
+}
+
+// Composes the page into fb: rows [v.top, v.top + height) from row(pos, r), a status line
+// with the rows shown and the key help at the bottom. The caller flushes the frame.
+inline void pager_Draw(FrameBuffer &fb, PagerView &v, long long count, const std::function<void(long long, PagerRow &)> &row, const std::string &keys)
+{
+    const int gap = 2;
+    size_t n = v.columns.size();
+    v.height = std::max(1, fb.height - PAGER_CHROME);
+    pager_Clamp(v, count);
+    long long last = std::min(count, v.top + v.height);
+
+    // Fetch the page first so the widths it needs are known before anything is placed
+    v.page.resize((size_t)(last - v.top));
+    for (long long p = v.top; p < last; p++)
+    {
+        PagerRow &r = v.page[(size_t)(p - v.top)];
+        r.cells.resize(n);
+        for (std::string &cell : r.cells)
+            cell.clear();
+        r.colors.assign(n, FC_DEFAULT);
+        row(p, r);
+        for (size_t c = 0; c < n; c++)
+        {
+            PagerColumn &col = v.columns[c];
+            col.width = std::max(col.width, std::min((int)r.cells[c].size(), col.maxWidth));
+        }
+    }
+
+    frame_Clear(fb);
+    frame_Text(fb, 3, 0, v.title, v.titleColor);
+    int x = 0;
+    for (const PagerColumn &col : v.columns)
+    {
+        frame_Text(fb, x, 1, col.title);
+        x += col.width + gap;
+    }
+    for (int i = 0; i < std::min(x - gap, fb.width); i++)
+        frame_Put(fb, i, 2, '-');
+    for (size_t k = 0; k < v.page.size(); k++)
+    {
+        x = 0;
+        for (size_t c = 0; c < n; c++)
+        {
+            const PagerColumn &col = v.columns[c];
+            std::string_view cell = v.page[k].cells[c];
+            frame_Text(fb, x, 3 + (int)k, cell.substr(0, (size_t)col.width), v.page[k].colors[c]);
+            x += col.width + gap;
+        }
+    }
+    std::string status = "Rows " + std::to_string(count == 0 ? 0 : v.top + 1) + "-" + std::to_string(last) + " of " + std::to_string(count);
+    frame_Text(fb, 0, fb.height - 2, status, FC_CYAN);
+    frame_Text(fb, 0, fb.height - 1, keys);
+}
+
+#endif
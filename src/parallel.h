@@ -0,0 +1,56 @@
+/**
+ * @file parallel.h
+ * @brief Small fork/join helpers for running independent work on several threads.
+ *
+ * @details
+ * Work is handed out from a shared atomic counter, so threads that finish early pick up
+ * the remaining items. Every call joins its threads before returning; there is no pool
+ * state left running in the background.
+ */
+
+#ifndef NMS_PARALLEL_H
+#define NMS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Worker threads to use for a job of n independent items
+inline int parallel_Threads(int n, int limit = 8)
+{
+    int hw = (int)std::thread::hardware_concurrency();
+    if (hw <= 0)
+        hw = 2;
+    return std::max(1, std::min(std::min(hw, limit), n));
+}
+
+// Runs fn(i) for every i in [0, n) on up to threads threads and waits for all of them
+inline void parallel_For(int n, int threads, const std::function<void(int)> &fn)
+{
+    if (n <= 0)
+        return;
+    threads = std::max(1, std::min(threads, n));
+    std::atomic<int> next(0);
+    auto worker = [&]()
+    {
+        for (int i = next++; i < n; i = next++)
+            fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread &t : pool)
+        t.join();
+}
+
+// Runs a list of independent tasks concurrently and waits for all of them
+inline void parallel_Run(const std::vector<std::function<void()>> &tasks, int threads)
+{
+    parallel_For((int)tasks.size(), threads, [&](int i)
+                 { tasks[i](); });
+}
+
+#endif
@@ -0,0 +1,475 @@
+/**
+ * @file pathfind.h
+ * @brief Shortest paths on a bit-packed occupancy grid, by A* and by jump-point search.
+ *
+ * @details
+ * A PathGrid keeps one bit per cell, set where the cell is blocked, in rows of 64-bit
+ * words; a 4096 x 4096 map is 2 MiB. A transposed copy (one line per column) is kept beside
+ * it so runs along a column can be scanned the same way as runs along a row. Cells outside
+ * the map, and the padding bits after the last column, read as blocked.
+ *
+ * Moves go to the 8 neighbours, 1 straight and sqrt(2) diagonally, and a diagonal move may
+ * not cut the corner of a blocked cell. Both searches use the octile distance as heuristic
+ * and return paths of the same, shortest, length.
+ *
+ * path_Jps is jump-point search (Harabor and Grastien) for that move set. Straight jumps
+ * look at 64 cells per step: the stop cells of a run, blocked cells and the cells where a
+ * neighbour line turns from blocked to free, are found with shifts and masks over the three
+ * lines and a count of trailing (or leading) zeros. A diagonal jump steps one cell at a time
+ * and starts a straight scan both ways at each cell.
+ *
+ * The per-query state lives in a PathSearch: an open-addressing table from cell to node
+ * covering only the cells a query touched, so a query on a large map costs what it visits,
+ * not the size of the map, and buffers are reused from one query to the next.
+ */
+
+#ifndef NMS_PATHFIND_H
+#define NMS_PATHFIND_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+const double PATH_DIAGONAL = 1.4142135623730951;
+
+struct PathPoint
+{
+    int x = 0, y = 0;
+};
+
+inline bool operator==(PathPoint a, PathPoint b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+// Bit lines of one orientation of a grid: lines of length cells, words words each
+struct PathLines
+{
+    int lines = 0, length = 0, words = 0;
+    std::vector<std::uint64_t> bits;
+};
+
+struct PathGrid
+{
+    int width = 0, height = 0;
+    PathLines rows; // Line y, bit x
+    PathLines cols; // Line x, bit y
+};
+
+struct PathNode
+{
+    std::uint64_t cell = 0;
+    std::int32_t parent = -1; // Node the best path so far came from
+    bool closed = false;
+    double g = 0;             // Length of that path
+};
+
+struct PathOpen
+{
+    double f, g;
+    std::uint32_t node;
+};
+
+// Scratch space of a search, kept by the caller between queries
+struct PathSearch
+{
+    std::vector<std::uint32_t> slots; // Node index + 1 per table slot, 0 when empty
+    std::vector<std::uint32_t> used;  // Slots to empty before the next query
+    std::vector<PathNode> nodes;
+    std::vector<PathOpen> open; // Binary heap
+};
+
+struct PathResult
+{
+    bool found = false;
+    double cost = 0;
+    std::vector<PathPoint> points; // Turning points from start to goal, both included
+    long long expanded = 0;        // Nodes taken off the open list
+};
+
+inline int path_Ctz(std::uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return (int)i;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+inline int path_Clz(std::uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return 63 - (int)i;
+#else
+    return __builtin_clzll(v);
+#endif
+}
+
+inline void path_Lines(PathLines &l, int lines, int length)
+{
+    l.lines = lines;
+    l.length = length;
+    l.words = (length + 63) / 64;
+    l.bits.assign((size_t)lines * l.words, 0);
+    if (length % 64)
+        for (int i = 0; i < lines; i++)
+            l.bits[(size_t)i * l.words + l.words - 1] = ~0ull << (length % 64);
+}
+
+// Word w of line i, all blocked outside the map
+inline std::uint64_t path_Word(const PathLines &l, int i, int w)
+{
+    if (i < 0 || i >= l.lines || w < 0 || w >= l.words)
+        return ~0ull;
+    return l.bits[(size_t)i * l.words + w];
+}
+
+inline void path_Init(PathGrid &g, int width, int height)
+{
+    g.width = width;
+    g.height = height;
+    path_Lines(g.rows, height, width);
+    path_Lines(g.cols, width, height);
+}
+
+inline void path_Set(PathGrid &g, int x, int y, bool blocked)
+{
+    std::uint64_t &r = g.rows.bits[(size_t)y * g.rows.words + x / 64];
+    std::uint64_t &c = g.cols.bits[(size_t)x * g.cols.words + y / 64];
+    if (blocked)
+    {
+        r |= 1ull << (x % 64);
+        c |= 1ull << (y % 64);
+    }
+    else
+    {
+        r &= ~(1ull << (x % 64));
+        c &= ~(1ull << (y % 64));
+    }
+}
+
+inline bool path_Free(const PathGrid &g, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= g.width || y >= g.height)
+        return false;
+    return !((g.rows.bits[(size_t)y * g.rows.words + x / 64] >> (x % 64)) & 1);
+}
+
+inline double path_Octile(PathPoint a, PathPoint b)
+{
+    int dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+    return std::max(dx, dy) + (PATH_DIAGONAL - 1) * std::min(dx, dy);
+}
+
+// Straight jump along line i of l from position p in direction d (+1 or -1): the first
+// position that is the goal (goal, or -1 when the goal is not on the line) or has a forced
+// neighbour, or -1 when a blocked cell comes first. A neighbour is forced where the next
+// line is free at the position and blocked at the one before it.
+inline int path_Scan(const PathLines &l, int i, int p, int d, int goal)
+{
+    if (p < 0 || p >= l.length)
+        return -1;
+    int w = p / 64;
+    if (d > 0)
+    {
+        std::uint64_t first = ~0ull << (p % 64);
+        for (;; w++, first = ~0ull)
+        {
+            std::uint64_t b = path_Word(l, i, w);
+            std::uint64_t up = path_Word(l, i - 1, w), down = path_Word(l, i + 1, w);
+            std::uint64_t stop = b;
+            stop |= ~up & ((up << 1) | (path_Word(l, i - 1, w - 1) >> 63));
+            stop |= ~down & ((down << 1) | (path_Word(l, i + 1, w - 1) >> 63));
+            if (goal >= 0 && goal / 64 == w)
+                stop |= 1ull << (goal % 64);
+            stop &= first;
+            if (stop)
+            {
+                int bit = path_Ctz(stop);
+                return ((b >> bit) & 1) ? -1 : w * 64 + bit;
+            }
+        }
+    }
+    std::uint64_t first = ~0ull >> (63 - p % 64);
+    for (;; w--, first = ~0ull)
+    {
+        std::uint64_t b = path_Word(l, i, w);
+        std::uint64_t up = path_Word(l, i - 1, w), down = path_Word(l, i + 1, w);
+        std::uint64_t stop = b;
+        stop |= ~up & ((up >> 1) | (path_Word(l, i - 1, w + 1) << 63));
+        stop |= ~down & ((down >> 1) | (path_Word(l, i + 1, w + 1) << 63));
+        if (goal >= 0 && goal / 64 == w)
+            stop |= 1ull << (goal % 64);
+        stop &= first;
+        if (stop)
+        {
+            int bit = 63 - path_Clz(stop);
+            return ((b >> bit) & 1) ? -1 : w * 64 + bit;
+        }
+    }
+}
+
+// Jump from p, the first cell past the node it came from, in direction (dx, dy)
+inline bool path_Jump(const PathGrid &g, PathPoint p, int dx, int dy, PathPoint goal, PathPoint &out)
+{
+    if (dy == 0)
+    {
+        int x = path_Scan(g.rows, p.y, p.x, dx, goal.y == p.y ? goal.x : -1);
+        out = {x, p.y};
+        return x >= 0;
+    }
+    if (dx == 0)
+    {
+        int y = path_Scan(g.cols, p.x, p.y, dy, goal.x == p.x ? goal.y : -1);
+        out = {p.x, y};
+        return y >= 0;
+    }
+    PathPoint t;
+    while (path_Free(g, p.x, p.y))
+    {
+        if (p == goal || path_Jump(g, {p.x + dx, p.y}, dx, 0, goal, t) || path_Jump(g, {p.x, p.y + dy}, 0, dy, goal, t))
+        {
+            out = p;
+            return true;
+        }
+        if (!path_Free(g, p.x + dx, p.y) || !path_Free(g, p.x, p.y + dy))
+            return false;
+        p.x += dx;
+        p.y += dy;
+    }
+    return false;
+}
+
+inline std::uint32_t path_Slot(const PathSearch &s, std::uint64_t cell)
+{
+    return (std::uint32_t)((cell * 0x9E3779B97F4A7C15ull) >> 32) & (std::uint32_t)(s.slots.size() - 1);
+}
+
+// Node of cell, added when the query has not touched it yet
+inline std::uint32_t path_Node(PathSearch &s, std::uint64_t cell)
+{
+    if ((s.nodes.size() + 1) * 2 > s.slots.size())
+    {
+        // Grow the table and put the nodes back
+        std::vector<std::uint32_t>().swap(s.used);
+        s.slots.assign(std::max<size_t>(4096, s.slots.size() * 2), 0);
+        for (std::uint32_t n = 0; n < s.nodes.size(); n++)
+        {
+            std::uint32_t k = path_Slot(s, s.nodes[n].cell);
+            while (s.slots[k])
+                k = (k + 1) & (std::uint32_t)(s.slots.size() - 1);
+            s.slots[k] = n + 1;
+            s.used.push_back(k);
+        }
+    }
+    std::uint32_t k = path_Slot(s, cell);
+    while (s.slots[k])
+    {
+        if (s.nodes[s.slots[k] - 1].cell == cell)
+            return s.slots[k] - 1;
+        k = (k + 1) & (std::uint32_t)(s.slots.size() - 1);
+    }
+    PathNode n;
+    n.cell = cell;
+    n.g = HUGE_VAL;
+    s.nodes.push_back(n);
+    s.slots[k] = (std::uint32_t)s.nodes.size();
+    s.used.push_back(k);
+    return (std::uint32_t)s.nodes.size() - 1;
+}
+
+inline void path_Reset(PathSearch &s)
+{
+    for (std::uint32_t k : s.used)
+        s.slots[k] = 0;
+    s.used.clear();
+    s.nodes.clear();
+    s.open.clear();
+}
+
+inline bool path_Later(const PathOpen &a, const PathOpen &b)
+{
+    return a.f > b.f || (a.f == b.f && a.g < b.g); // Ties go to the node further along
+}
+
+// Best-first search from start to goal; successors(p, parent, hasParent, add) calls
+// add(q) for every point the search may move to from p
+template <class Successors>
+bool path_Search(const PathGrid &g, PathPoint start, PathPoint goal, PathSearch &s, PathResult &out, Successors successors)
+{
+    path_Reset(s);
+    out = PathResult();
+    if (!path_Free(g, start.x, start.y) || !path_Free(g, goal.x, goal.y))
+        return false;
+    auto cellOf = [&](PathPoint p)
+    { return (std::uint64_t)p.y * (std::uint64_t)g.width + (std::uint64_t)p.x; };
+    auto pointOf = [&](std::uint64_t c)
+    { return PathPoint{(int)(c % (std::uint64_t)g.width), (int)(c / (std::uint64_t)g.width)}; };
+
+    std::uint32_t first = path_Node(s, cellOf(start));
+    s.nodes[first].g = 0;
+    s.open.push_back({path_Octile(start, goal), 0, first});
+    while (!s.open.empty())
+    {
+        std::pop_heap(s.open.begin(), s.open.end(), path_Later);
+        PathOpen top = s.open.back();
+        s.open.pop_back();
+        if (s.nodes[top.node].closed || top.g > s.nodes[top.node].g)
+            continue;
+        s.nodes[top.node].closed = true;
+        out.expanded++;
+        PathPoint p = pointOf(s.nodes[top.node].cell);
+        if (p == goal)
+        {
+            out.found = true;
+            out.cost = s.nodes[top.node].g;
+            for (std::int32_t n = (std::int32_t)top.node; n >= 0; n = s.nodes[n].parent)
+                out.points.push_back(pointOf(s.nodes[n].cell));
+            std::reverse(out.points.begin(), out.points.end());
+            return true;
+        }
+        std::int32_t parent = s.nodes[top.node].parent;
+        PathPoint from = parent >= 0 ? pointOf(s.nodes[parent].cell) : p;
+        double base = s.nodes[top.node].g;
+        successors(p, from, parent >= 0, [&](PathPoint q)
+                   {
+                       std::uint32_t n = path_Node(s, cellOf(q));
+                       double cost = base + path_Octile(p, q);
+                       if (s.nodes[n].closed || cost >= s.nodes[n].g)
+                           return;
+                       s.nodes[n].g = cost;
+                       s.nodes[n].parent = (std::int32_t)top.node;
+                       s.open.push_back({cost + path_Octile(q, goal), cost, n});
+                       std::push_heap(s.open.begin(), s.open.end(), path_Later); });
+    }
+    return false;
+}
+
+// Plain A* over the 8 neighbours of every cell
+inline bool path_AStar(const PathGrid &g, PathPoint start, PathPoint goal, PathSearch &s, PathResult &out)
+{
+    return path_Search(g, start, goal, s, out, [&](PathPoint p, PathPoint, bool, auto add)
+                       {
+                           for (int dy = -1; dy <= 1; dy++)
+                               for (int dx = -1; dx <= 1; dx++)
+                               {
+                                   if ((dx == 0 && dy == 0) || !path_Free(g, p.x + dx, p.y + dy))
+                                       continue;
+                                   if (dx != 0 && dy != 0 && (!path_Free(g, p.x + dx, p.y) || !path_Free(g, p.x, p.y + dy)))
+                                       continue;
+                                   add(PathPoint{p.x + dx, p.y + dy});
+                               } });
+}
+
+// Jump-point search: only the neighbours the move from the parent leaves open are tried,
+// and each is followed to its jump point
+inline bool path_Jps(const PathGrid &g, PathPoint start, PathPoint goal, PathSearch &s, PathResult &out)
+{
+    return path_Search(g, start, goal, s, out, [&](PathPoint p, PathPoint from, bool hasParent, auto add)
+                       {
+                           int dirs[8][2];
+                           int count = 0;
+                           auto dir = [&](int dx, int dy)
+                           {
+                               dirs[count][0] = dx;
+                               dirs[count][1] = dy;
+                               count++;
+                           };
+                           int dx = (p.x > from.x) - (p.x < from.x), dy = (p.y > from.y) - (p.y < from.y);
+                           if (!hasParent)
+                           {
+                               for (int y = -1; y <= 1; y++)
+                                   for (int x = -1; x <= 1; x++)
+                                       if (x != 0 || y != 0)
+                                           dir(x, y);
+                           }
+                           else if (dx != 0 && dy != 0)
+                           {
+                               dir(0, dy);
+                               dir(dx, 0);
+                               dir(dx, dy);
+                           }
+                           else if (dx != 0)
+                           {
+                               dir(dx, 0);
+                               dir(dx, 1);
+                               dir(dx, -1);
+                               dir(0, 1);
+                               dir(0, -1);
+                           }
+                           else
+                           {
+                               dir(0, dy);
+                               dir(1, dy);
+                               dir(-1, dy);
+                               dir(1, 0);
+                               dir(-1, 0);
+                           }
+                           for (int k = 0; k < count; k++)
+                           {
+                               int mx = dirs[k][0], my = dirs[k][1];
+                               if (!path_Free(g, p.x + mx, p.y + my))
+                                   continue;
+                               if (mx != 0 && my != 0 && (!path_Free(g, p.x + mx, p.y) || !path_Free(g, p.x, p.y + my)))
+                                   continue;
+                               PathPoint jp;
+                               if (path_Jump(g, {p.x + mx, p.y + my}, mx, my, goal, jp))
+                                   add(jp);
+                           } });
+}
+
+// The cells of a path one move apart, from its turning points
+inline std::vector<PathPoint> path_Cells(const std::vector<PathPoint> &points)
+{
+    std::vector<PathPoint> cells;
+    for (size_t k = 0; k < points.size(); k++)
+    {
+        if (k == 0)
+        {
+            cells.push_back(points[0]);
+            continue;
+        }
+        PathPoint p = points[k - 1], q = points[k];
+        while (!(p == q))
+        {
+            p.x += (q.x > p.x) - (q.x < p.x);
+            p.y += (q.y > p.y) - (q.y < p.y);
+            cells.push_back(p);
+        }
+    }
+    return cells;
+}
+
+// Every free cell a path from start can reach, start first. Without corner cutting a diagonal
+// move needs both straight neighbours free, so the 4 straight neighbours decide reachability.
+inline std::vector<PathPoint> path_Reachable(const PathGrid &g, PathPoint start)
+{
+    std::vector<PathPoint> cells;
+    if (!path_Free(g, start.x, start.y))
+        return cells;
+    std::vector<char> seen((size_t)g.width * g.height, 0);
+    seen[(size_t)start.y * g.width + start.x] = 1;
+    cells.push_back(start);
+    const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+    for (size_t k = 0; k < cells.size(); k++)
+        for (int d = 0; d < 4; d++)
+        {
+            PathPoint q{cells[k].x + dx[d], cells[k].y + dy[d]};
+            if (!path_Free(g, q.x, q.y) || seen[(size_t)q.y * g.width + q.x])
+                continue;
+            seen[(size_t)q.y * g.width + q.x] = 1;
+            cells.push_back(q);
+        }
+    return cells;
+}
+
+#endif
@@ -0,0 +1,771 @@
+/**
+ * @file query.h
+ * @brief Filter, group, aggregate and sort queries over the in-memory tables.
+ *
+ * @details
+ * A query is written as words, the same in the console and in batch scripts:
+ *
+ *   <table> [where <column> <op> <value> [and ...]] [by <column>]
+ *           [count] [sum|avg|min|max <column>[*<column>]]...
+ *           [order <column> | order count | order sum|avg|min|max <column>[*<column>] [asc|desc]]
+ *           [limit <n>]
+ *
+ * with op one of = != < <= > >= and ~ (contains). For example
+ *
+ *   inventory where category = Propulsion sum quantity*cost
+ *   missions by requester count sum cost order sum cost desc
+ *   exoplanets where habitable = 1 and distance < 50 order distance
+ *
+ * Columns are found by the labels given to TABLE_COLUMN. Filters scan one column at a time
+ * over the candidate rows; on a dictionary column the condition is evaluated once per
+ * distinct value and the scan only looks codes up. A query without aggregates lists the
+ * matching records; ordering such a list walks a sort permutation of the whole column that
+ * is cached between queries and rebuilt only when the table has grown or shrunk or the
+ * permutation is no longer in order (checking costs one pass, sorting n log n), and it
+ * stops as soon as the limit is reached.
+ *
+ * Query results refer to the table columns; they are valid until the table is changed.
+ */
+
+#ifndef NMS_QUERY_H
+#define NMS_QUERY_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "csv.h"
+#include "table.h"
+
+enum QueryOp : std::uint8_t
+{
+    QUERY_EQ,
+    QUERY_NE,
+    QUERY_LT,
+    QUERY_LE,
+    QUERY_GT,
+    QUERY_GE,
+    QUERY_HAS
+};
+
+enum QueryAgg : std::uint8_t
+{
+    QUERY_COUNT,
+    QUERY_SUM,
+    QUERY_AVG,
+    QUERY_MIN,
+    QUERY_MAX
+};
+
+enum QueryKind : std::uint8_t
+{
+    QUERY_TEXT,
+    QUERY_DICT,
+    QUERY_NUMBER,
+    QUERY_BOOL
+};
+
+struct QueryTerm
+{
+    std::string column;
+    QueryOp op = QUERY_EQ;
+    std::string value;
+};
+
+struct QueryMeasure
+{
+    QueryAgg agg = QUERY_COUNT;
+    std::string column; // Empty for count
+    std::string times;  // Optional second column multiplied in, e.g. quantity*cost
+};
+
+struct Query
+{
+    std::string table;
+    std::vector<QueryTerm> where;
+    std::string group;
+    std::vector<QueryMeasure> measures;
+    std::string order;      // Column label, or the label of a measure
+    bool desc = false;
+    long long limit = -1;   // -1 for no limit
+};
+
+// One column of a table as the engine sees it
+struct QueryColumn
+{
+    const char *name = "";
+    QueryKind kind = QUERY_TEXT;
+    const Column<std::string> *text = nullptr;
+    const Column<DictString> *dict = nullptr;
+    const Column<double> *number = nullptr;
+    const Column<bool> *flag = nullptr;
+};
+
+struct QueryResult
+{
+    std::vector<std::string> header;
+    std::vector<QueryColumn> columns;             // Columns of the records listed
+    std::vector<int> rows;                        // Records listed, in result order
+    std::vector<std::vector<std::string>> groups; // Lines of an aggregate query
+    bool aggregate = false;
+    long long scanned = 0;  // Live rows in the table
+    long long matched = 0;  // Rows that passed the filters
+    bool sortCached = false;
+    double ms = 0;
+};
+
+// Sort permutation of a whole column, kept between queries
+struct QuerySort
+{
+    const void *column = nullptr;
+    std::vector<int> perm;
+};
+
+inline std::vector<QuerySort> &query_Sorts()
+{
+    static std::vector<QuerySort> sorts;
+    return sorts;
+}
+
+inline void query_Bind(QueryColumn &c, const Column<std::string> &col)
+{
+    c.kind = QUERY_TEXT;
+    c.text = &col;
+}
+inline void query_Bind(QueryColumn &c, const Column<DictString> &col)
+{
+    c.kind = QUERY_DICT;
+    c.dict = &col;
+}
+inline void query_Bind(QueryColumn &c, const Column<double> &col)
+{
+    c.kind = QUERY_NUMBER;
+    c.number = &col;
+}
+inline void query_Bind(QueryColumn &c, const Column<bool> &col)
+{
+    c.kind = QUERY_BOOL;
+    c.flag = &col;
+}
+
+template <class... Cols>
+std::vector<QueryColumn> query_Columns(const Table<Cols...> &t)
+{
+    std::vector<QueryColumn> cols;
+    auto add = [&](const auto &col, const char *name)
+    {
+        QueryColumn c;
+        c.name = name;
+        query_Bind(c, col);
+        cols.push_back(c);
+    };
+    (add(t.template col<Cols>(), Cols::name), ...);
+    return cols;
+}
+
+inline int query_Find(const std::vector<QueryColumn> &cols, const std::string &name)
+{
+    for (size_t i = 0; i < cols.size(); i++)
+        if (name == cols[i].name)
+            return (int)i;
+    return -1;
+}
+
+inline bool query_Numeric(const QueryColumn &c)
+{
+    return c.kind == QUERY_NUMBER || c.kind == QUERY_BOOL;
+}
+
+inline double query_Number(const QueryColumn &c, int row)
+{
+    return c.kind == QUERY_NUMBER ? (*c.number)[row] : ((*c.flag)[row] ? 1.0 : 0.0);
+}
+
+inline std::string query_FormatNumber(double v)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%g", v);
+    return buf;
+}
+
+inline std::string query_Text(const QueryColumn &c, int row)
+{
+    switch (c.kind)
+    {
+    case QUERY_TEXT:
+        return std::string((*c.text)[row]);
+    case QUERY_DICT:
+        return std::string((*c.dict)[row]);
+    case QUERY_NUMBER:
+        return query_FormatNumber((*c.number)[row]);
+    case QUERY_BOOL:
+        return (*c.flag)[row] ? "1" : "0";
+    }
+    return std::string();
+}
+
+inline std::string query_Label(const QueryMeasure &m)
+{
+    static const char *names[] = {"count", "sum", "avg", "min", "max"};
+    if (m.agg == QUERY_COUNT)
+        return "count";
+    return std::string(names[m.agg]) + "(" + m.column + (m.times.empty() ? "" : "*" + m.times) + ")";
+}
+
+inline bool query_ParseOp(const std::string &w, QueryOp &op)
+{
+    static const char *ops[] = {"=", "!=", "<", "<=", ">", ">=", "~"};
+    for (int i = 0; i < 7; i++)
+        if (w == ops[i])
+        {
+            op = (QueryOp)i;
+            return true;
+        }
+    return false;
+}
+
+inline bool query_ParseAgg(const std::string &w, QueryAgg &agg)
+{
+    static const char *aggs[] = {"count", "sum", "avg", "min", "max"};
+    for (int i = 0; i < 5; i++)
+        if (w == aggs[i])
+        {
+            agg = (QueryAgg)i;
+            return true;
+        }
+    return false;
+}
+
+// Reads an aggregate starting at words[i], advancing i past it
+inline bool query_ParseMeasure(const std::vector<std::string> &words, size_t &i, QueryMeasure &m)
+{
+    if (!query_ParseAgg(words[i], m.agg))
+        return false;
+    if (m.agg == QUERY_COUNT)
+    {
+        i++;
+        return true;
+    }
+    if (i + 1 >= words.size())
+        return false;
+    const std::string &spec = words[i + 1];
+    size_t star = spec.find('*');
+    m.column = spec.substr(0, star);
+    m.times = (star == std::string::npos ? "" : spec.substr(star + 1));
+    if (m.column.empty())
+        return false;
+    i += 2;
+    return true;
+}
+
+// Parses words[first...] into q, false with a message in error when they are not a query
+inline bool query_Parse(const std::vector<std::string> &words, size_t first, Query &q, std::string &error)
+{
+    size_t i = first, n = words.size();
+    if (i >= n)
+    {
+        error = "no table given";
+        return false;
+    }
+    q = Query();
+    q.table = words[i++];
+    while (i < n)
+    {
+        const std::string &w = words[i];
+        QueryMeasure m;
+        if (w == "where" || w == "and")
+        {
+            QueryTerm t;
+            if (i + 3 >= n)
+            {
+                error = "expected: " + w + " <column> <op> <value>";
+                return false;
+            }
+            t.column = words[i + 1];
+            if (!query_ParseOp(words[i + 2], t.op))
+            {
+                error = "unknown operator " + words[i + 2] + ", use = != < <= > >= ~";
+                return false;
+            }
+            t.value = words[i + 3];
+            q.where.push_back(t);
+            i += 4;
+        }
+        else if (w == "by")
+        {
+            if (i + 1 >= n)
+            {
+                error = "expected: by <column>";
+                return false;
+            }
+            q.group = words[i + 1];
+            i += 2;
+        }
+        else if (query_ParseMeasure(words, i, m))
+            q.measures.push_back(m);
+        else if (w == "order")
+        {
+            i++;
+            if (i >= n)
+            {
+                error = "expected: order <column>";
+                return false;
+            }
+            if (query_ParseMeasure(words, i, m))
+            {
+                q.order = query_Label(m);
+                bool listed = false;
+                for (const QueryMeasure &x : q.measures)
+                    listed = listed || query_Label(x) == q.order;
+                if (!listed)
+                    q.measures.push_back(m);
+            }
+            else
+                q.order = words[i++];
+            if (i < n && (words[i] == "asc" || words[i] == "desc"))
+                q.desc = (words[i++] == "desc");
+        }
+        else if (w == "limit")
+        {
+            int v;
+            if (i + 1 >= n || !csv_Field(words[i + 1], v) || v < 0)
+            {
+                error = "expected: limit <n>";
+                return false;
+            }
+            q.limit = v;
+            i += 2;
+        }
+        else
+        {
+            error = "unexpected " + w;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Keeps the rows of sel for which keep(row) holds, in order
+template <class Keep>
+void query_Keep(std::vector<int> &sel, Keep keep)
+{
+    size_t k = 0;
+    for (int r : sel)
+    {
+        sel[k] = r;
+        k += keep(r) ? 1 : 0;
+    }
+    sel.resize(k);
+}
+
+template <class A, class B>
+bool query_Test(QueryOp op, const A &a, const B &b)
+{
+    switch (op)
+    {
+    case QUERY_EQ:
+        return a == b;
+    case QUERY_NE:
+        return a != b;
+    case QUERY_LT:
+        return a < b;
+    case QUERY_LE:
+        return a <= b;
+    case QUERY_GT:
+        return a > b;
+    case QUERY_GE:
+        return a >= b;
+    default:
+        return false;
+    }
+}
+
+// Applies one condition to the candidate rows
+inline bool query_Filter(const QueryColumn &c, const QueryTerm &t, std::vector<int> &sel, std::string &error)
+{
+    if (query_Numeric(c))
+    {
+        double v;
+        bool b;
+        if (t.op == QUERY_HAS)
+        {
+            error = std::string("~ needs a text column, ") + c.name + " is a number";
+            return false;
+        }
+        if (c.kind == QUERY_BOOL && csv_Field(t.value, b))
+            v = b ? 1.0 : 0.0;
+        else if (!csv_Field(t.value, v))
+        {
+            error = std::string(c.name) + " is a number, " + t.value + " is not";
+            return false;
+        }
+        if (c.kind == QUERY_NUMBER)
+        {
+            const Column<double> &col = *c.number;
+            switch (t.op)
+            {
+            case QUERY_EQ:
+                query_Keep(sel, [&](int r) { return col[r] == v; });
+                break;
+            case QUERY_NE:
+                query_Keep(sel, [&](int r) { return col[r] != v; });
+                break;
+            case QUERY_LT:
+                query_Keep(sel, [&](int r) { return col[r] < v; });
+                break;
+            case QUERY_LE:
+                query_Keep(sel, [&](int r) { return col[r] <= v; });
+                break;
+            case QUERY_GT:
+                query_Keep(sel, [&](int r) { return col[r] > v; });
+                break;
+            case QUERY_GE:
+                query_Keep(sel, [&](int r) { return col[r] >= v; });
+                break;
+            default:
+                break;
+            }
+        }
+        else
+            query_Keep(sel, [&](int r) { return query_Test(t.op, (*c.flag)[r] ? 1.0 : 0.0, v); });
+        return true;
+    }
+    std::string_view v = t.value;
+    auto pass = [&](std::string_view s)
+    { return t.op == QUERY_HAS ? s.find(v) != std::string_view::npos : query_Test(t.op, s, v); };
+    if (c.kind == QUERY_DICT)
+    {
+        // Decide once per distinct value, then the scan only looks codes up
+        const Column<DictString> &col = *c.dict;
+        std::vector<char> ok(col.dict.values.size());
+        for (size_t code = 0; code < ok.size(); code++)
+            ok[code] = pass(col.dict.values[code]);
+        query_Keep(sel, [&](int r) { return ok[col.codes[r]] != 0; });
+    }
+    else
+    {
+        const Column<std::string> &col = *c.text;
+        query_Keep(sel, [&](int r) { return pass(col[r]); });
+    }
+    return true;
+}
+
+// Rank of every dictionary code in the sorted order of the values
+inline std::vector<std::uint32_t> query_DictRanks(const Column<DictString> &col)
+{
+    size_t n = col.dict.values.size();
+    std::vector<std::uint32_t> order(n), rank(n);
+    for (size_t i = 0; i < n; i++)
+        order[i] = (std::uint32_t)i;
+    std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b)
+              { return col.dict.values[a] < col.dict.values[b]; });
+    for (size_t i = 0; i < n; i++)
+        rank[order[i]] = (std::uint32_t)i;
+    return rank;
+}
+
+// Permutation of all rows of a column in ascending order, from the cache when it still holds
+inline const std::vector<int> &query_SortPerm(const QueryColumn &c, int rows, bool &cached)
+{
+    const void *key = c.text ? (const void *)c.text : c.dict ? (const void *)c.dict : c.number ? (const void *)c.number : (const void *)c.flag;
+    std::vector<QuerySort> &sorts = query_Sorts();
+    QuerySort *s = nullptr;
+    for (QuerySort &x : sorts)
+        if (x.column == key)
+            s = &x;
+    if (!s)
+    {
+        sorts.push_back(QuerySort());
+        s = &sorts.back();
+        s->column = key;
+    }
+
+    // Numbers and dictionary codes are compared through a key array, text directly
+    std::vector<double> keys;
+    if (c.kind != QUERY_TEXT)
+    {
+        keys.resize(rows);
+        if (c.kind == QUERY_DICT)
+        {
+            std::vector<std::uint32_t> rank = query_DictRanks(*c.dict);
+            for (int r = 0; r < rows; r++)
+                keys[r] = rank[c.dict->codes[r]];
+        }
+        else
+            for (int r = 0; r < rows; r++)
+                keys[r] = query_Number(c, r);
+    }
+    auto less = [&](int a, int b)
+    { return c.kind == QUERY_TEXT ? (*c.text)[a] < (*c.text)[b] : keys[a] < keys[b]; };
+
+    std::vector<int> &perm = s->perm;
+    cached = ((int)perm.size() == rows);
+    for (int k = 1; cached && k < rows; k++)
+        cached = !less(perm[k], perm[k - 1]);
+    if (!cached)
+    {
+        perm.resize(rows);
+        for (int r = 0; r < rows; r++)
+            perm[r] = r;
+        std::stable_sort(perm.begin(), perm.end(), less);
+    }
+    return perm;
+}
+
+// Runs q over a table given as its columns and tombstone flags
+inline bool query_Exec(const std::vector<QueryColumn> &cols, int rows, const Column<bool> &dead, const Query &q, QueryResult &res, std::string &error)
+{
+    auto started = std::chrono::steady_clock::now();
+    res = QueryResult();
+    auto column = [&](const std::string &name, int &idx)
+    {
+        idx = query_Find(cols, name);
+        if (idx >= 0)
+            return true;
+        error = "no column " + name + " in " + q.table + ", columns are";
+        for (const QueryColumn &c : cols)
+            error += std::string(" ") + c.name;
+        return false;
+    };
+
+    // Candidate rows: every live row, then narrowed one condition at a time
+    std::vector<int> sel;
+    sel.reserve(rows);
+    for (int r = 0; r < rows; r++)
+        if (!dead[r])
+            sel.push_back(r);
+    res.scanned = (long long)sel.size();
+    for (const QueryTerm &t : q.where)
+    {
+        int c;
+        if (!column(t.column, c) || !query_Filter(cols[c], t, sel, error))
+            return false;
+    }
+    res.matched = (long long)sel.size();
+
+    if (q.group.empty() && q.measures.empty())
+    {
+        // A list of records
+        res.header.push_back("id");
+        for (const QueryColumn &c : cols)
+            res.header.push_back(c.name);
+        res.columns = cols;
+        size_t limit = q.limit < 0 ? sel.size() : std::min(sel.size(), (size_t)q.limit);
+        if (q.order.empty())
+            sel.resize(limit);
+        else
+        {
+            int c;
+            if (!column(q.order, c))
+                return false;
+            const std::vector<int> &perm = query_SortPerm(cols[c], rows, res.sortCached);
+            std::vector<char> keep(rows);
+            for (int r : sel)
+                keep[r] = 1;
+            sel.clear();
+            for (int k = 0; k < rows && sel.size() < limit; k++)
+            {
+                int r = perm[q.desc ? rows - 1 - k : k];
+                if (keep[r])
+                    sel.push_back(r);
+            }
+        }
+        res.rows.swap(sel);
+        res.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        return true;
+    }
+
+    // Aggregates, per group or over all the rows
+    res.aggregate = true;
+    struct Source
+    {
+        int a = -1, b = -1;
+    };
+    std::vector<Source> src(q.measures.size());
+    for (size_t m = 0; m < q.measures.size(); m++)
+    {
+        const QueryMeasure &qm = q.measures[m];
+        if (qm.agg == QUERY_COUNT)
+            continue;
+        if (!column(qm.column, src[m].a) || (!qm.times.empty() && !column(qm.times, src[m].b)))
+            return false;
+        for (int c : {src[m].a, src[m].b})
+            if (c >= 0 && !query_Numeric(cols[c]))
+            {
+                error = std::string("cannot total ") + cols[c].name + ", it is not a number";
+                return false;
+            }
+    }
+    int g = -1;
+    if (!q.group.empty() && !column(q.group, g))
+        return false;
+
+    // Group number of every selected row
+    std::vector<int> gid(sel.size(), 0);
+    std::vector<int> groupRow; // A row of each group, for its label
+    if (g < 0)
+        groupRow.push_back(sel.empty() ? -1 : sel[0]);
+    else if (cols[g].kind == QUERY_DICT)
+    {
+        const Column<DictString> &col = *cols[g].dict;
+        std::vector<int> byCode(col.dict.values.size(), -1);
+        for (size_t k = 0; k < sel.size(); k++)
+        {
+            int &id = byCode[col.codes[sel[k]]];
+            if (id < 0)
+            {
+                id = (int)groupRow.size();
+                groupRow.push_back(sel[k]);
+            }
+            gid[k] = id;
+        }
+    }
+    else
+    {
+        std::unordered_map<std::string, int> byText;
+        for (size_t k = 0; k < sel.size(); k++)
+        {
+            auto it = byText.emplace(query_Text(cols[g], sel[k]), (int)groupRow.size());
+            if (it.second)
+                groupRow.push_back(sel[k]);
+            gid[k] = it.first->second;
+        }
+    }
+
+    struct Acc
+    {
+        double count = 0, sum = 0, min = 0, max = 0;
+    };
+    size_t nm = q.measures.size(), ng = groupRow.size();
+    std::vector<Acc> acc(ng * std::max<size_t>(nm, 1));
+    std::vector<double> sizes(ng, 0);
+    for (size_t k = 0; k < sel.size(); k++)
+        sizes[gid[k]]++;
+    for (size_t m = 0; m < nm; m++)
+    {
+        if (src[m].a < 0)
+            continue;
+        const QueryColumn &a = cols[src[m].a];
+        const QueryColumn *b = src[m].b >= 0 ? &cols[src[m].b] : nullptr;
+        for (size_t k = 0; k < sel.size(); k++)
+        {
+            double v = query_Number(a, sel[k]) * (b ? query_Number(*b, sel[k]) : 1.0);
+            Acc &x = acc[gid[k] * nm + m];
+            x.min = (x.count == 0 || v < x.min) ? v : x.min;
+            x.max = (x.count == 0 || v > x.max) ? v : x.max;
+            x.sum += v;
+            x.count++;
+        }
+    }
+
+    if (g >= 0)
+        res.header.push_back(cols[g].name);
+    for (const QueryMeasure &m : q.measures)
+        res.header.push_back(query_Label(m));
+    if (nm == 0)
+        res.header.push_back("count"); // "by" alone counts the groups' rows
+    std::vector<std::vector<double>> values(ng);
+    for (size_t i = 0; i < ng; i++)
+    {
+        std::vector<std::string> line;
+        if (g >= 0)
+            line.push_back(query_Text(cols[g], groupRow[i]));
+        for (size_t m = 0; m < nm; m++)
+        {
+            const Acc &x = acc[i * nm + m];
+            double v = 0;
+            switch (q.measures[m].agg)
+            {
+            case QUERY_COUNT:
+                v = sizes[i];
+                break;
+            case QUERY_SUM:
+                v = x.sum;
+                break;
+            case QUERY_AVG:
+                v = x.count ? x.sum / x.count : 0;
+                break;
+            case QUERY_MIN:
+                v = x.min;
+                break;
+            case QUERY_MAX:
+                v = x.max;
+                break;
+            }
+            values[i].push_back(v);
+            line.push_back(query_FormatNumber(v));
+        }
+        if (nm == 0)
+        {
+            values[i].push_back(sizes[i]);
+            line.push_back(query_FormatNumber(sizes[i]));
+        }
+        res.groups.push_back(line);
+    }
+
+    // Groups come out in order of their first row unless ordered
+    std::vector<size_t> order(ng);
+    for (size_t i = 0; i < ng; i++)
+        order[i] = i;
+    if (!q.order.empty())
+    {
+        int by = -1;
+        for (size_t h = 0; h < res.header.size(); h++)
+            if (res.header[h] == q.order)
+                by = (int)h;
+        if (by < 0)
+        {
+            error = "cannot order by " + q.order + ", it is not in the result";
+            return false;
+        }
+        bool label = (g >= 0 && by == 0);
+        bool numericLabel = label && query_Numeric(cols[g]);
+        auto key = [&](size_t i)
+        { return label ? (numericLabel ? query_Number(cols[g], groupRow[i]) : 0.0) : values[i][by - (g >= 0 ? 1 : 0)]; };
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                         {
+                             bool less = (label && !numericLabel) ? res.groups[a][0] < res.groups[b][0] : key(a) < key(b);
+                             bool more = (label && !numericLabel) ? res.groups[b][0] < res.groups[a][0] : key(b) < key(a);
+                             return q.desc ? more : less; });
+    }
+    std::vector<std::vector<std::string>> sorted;
+    for (size_t i : order)
+        if (q.limit < 0 || (long long)sorted.size() < q.limit)
+            sorted.push_back(std::move(res.groups[i]));
+    res.groups.swap(sorted);
+    res.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+template <class... Cols>
+bool query_Run(const Table<Cols...> &t, const Query &q, QueryResult &res, std::string &error)
+{
+    return query_Exec(query_Columns(t), t.size(), t.dead, q, res, error);
+}
+
+// Lines in the result
+inline long long query_Count(const QueryResult &res)
+{
+    return res.aggregate ? (long long)res.groups.size() : (long long)res.rows.size();
+}
+
+// Cells of result line k, formatted only when asked for
+inline void query_Cells(const QueryResult &res, long long k, std::vector<std::string> &out)
+{
+    out.clear();
+    if (res.aggregate)
+    {
+        out = res.groups[(size_t)k];
+        return;
+    }
+    int r = res.rows[(size_t)k];
+    out.push_back(std::to_string(r + 1));
+    for (const QueryColumn &c : res.columns)
+        out.push_back(query_Text(c, r));
+}
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * @file render.h
+ * @brief Double-buffered console renderer for the full-screen NMS simulations.
+ *
+ * @details
+ * A FrameBuffer holds two grids of cells: the frame being composed and the frame that is
+ * currently on screen. A frame is drawn into the back grid with frame_Put/frame_Text and
+ * then handed to frame_Flush, which compares the two grids and writes only the cells that
+ * changed, using ANSI cursor moves to jump over unchanged runs and colour codes only where
+ * the colour changes. The whole update is built in one string and written with a single
+ * call, so a keystroke that moves one sprite costs a few dozen bytes instead of a screen
+ * clear and a stream write per cell.
+ *
+ * Each flush records how long the frame took from frame_Clear to the end of the write,
+ * split into compose and flush time, so the redraw cost can be shown and benchmarked.
+ */
+
+#ifndef NMS_RENDER_H
+#define NMS_RENDER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ANSI colour of a cell, the SGR number (0 is the default colour)
+enum FrameColor : std::uint8_t
+{
+    FC_DEFAULT = 0,
+    FC_RED = 31,
+    FC_GREEN = 32,
+    FC_YELLOW = 33,
+    FC_BLUE = 34,
+    FC_MAGENTA = 35,
+    FC_CYAN = 36,
+    FC_WHITE = 37,
+    FC_GRAY = 90
+};
+
+struct FrameCell
+{
+    char ch = ' ';
+    std::uint8_t color = FC_DEFAULT;
+    bool operator==(const FrameCell &o) const { return ch == o.ch && color == o.color; }
+    bool operator!=(const FrameCell &o) const { return !(*this == o); }
+};
+
+// Timing of the frames flushed so far, all times in milliseconds
+struct FrameStats
+{
+    long long frames = 0;
+    double composeMs = 0;   // Last frame, frame_Clear to frame_Flush
+    double flushMs = 0;     // Last frame, diff and write
+    double frameMs = 0;     // Last frame, compose + flush
+    double totalMs = 0;     // Sum of frameMs
+    double maxMs = 0;       // Slowest frame
+    int cells = 0;          // Cells written by the last frame
+    std::size_t bytes = 0;  // Bytes written by the last frame
+};
+
+struct FrameBuffer
+{
+    int width = 0, height = 0;
+    int originX = 0, originY = 0;  // Screen position of cell (0, 0), 0-based
+    std::vector<FrameCell> back;   // Frame being composed
+    std::vector<FrameCell> front;  // Frame on screen
+    bool valid = false;            // False until front matches the screen
+    std::string out;               // Update of the last flush, kept to reuse its capacity
+    std::chrono::steady_clock::time_point started;
+    FrameStats stats;
+};
+
+inline void frame_Init(FrameBuffer &fb, int width, int height, int originX = 0, int originY = 0)
+{
+    fb.width = width;
+    fb.height = height;
+    fb.originX = originX;
+    fb.originY = originY;
+    fb.back.assign((std::size_t)width * height, FrameCell());
+    fb.front.assign((std::size_t)width * height, FrameCell());
+    fb.valid = false;
+    fb.stats = FrameStats();
+}
+
+// Forces the next flush to redraw everything, e.g. after something else wrote to the screen
+inline void frame_Invalidate(FrameBuffer &fb)
+{
+    fb.valid = false;
+}
+
+// Starts a new frame: blanks the back grid and starts the frame clock
+inline void frame_Clear(FrameBuffer &fb)
+{
+    fb.started = std::chrono::steady_clock::now();
+    std::fill(fb.back.begin(), fb.back.end(), FrameCell());
+}
+
+inline void frame_Put(FrameBuffer &fb, int x, int y, char ch, std::uint8_t color = FC_DEFAULT)
+{
+    if (x < 0 || y < 0 || x >= fb.width || y >= fb.height)
+        return;
+    FrameCell &c = fb.back[(std::size_t)y * fb.width + x];
+    c.ch = ch;
+    c.color = color;
+}
+
+// Writes text from (x, y) rightwards, clipped at the edge of the frame
+inline void frame_Text(FrameBuffer &fb, int x, int y, std::string_view text, std::uint8_t color = FC_DEFAULT)
+{
+    for (std::size_t i = 0; i < text.size(); i++)
+        frame_Put(fb, x + (int)i, y, text[i], color);
+}
+
+inline void frame_AppendInt(std::string &out, int v)
+{
+    char buf[12];
+    int n = 0;
+    do
+    {
+        buf[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    while (n > 0)
+        out += buf[--n];
+}
+
+// Builds the escape sequence that brings the screen from front to back into fb.out, copies
+// back over front and returns the number of cells written
+inline int frame_Diff(FrameBuffer &fb)
+{
+    std::string &out = fb.out;
+    out.clear();
+    int cells = 0;
+    int curX = -1, curY = -1; // Cursor position after the last write, -1 when unknown
+    int color = -1;           // Colour in effect, -1 when unknown
+    if (!fb.valid)
+    {
+        // After a clear the screen is blank, so only the non-blank cells need writing
+        out += "\033[0m\033[2J";
+        std::fill(fb.front.begin(), fb.front.end(), FrameCell());
+    }
+    for (int y = 0; y < fb.height; y++)
+    {
+        const FrameCell *b = &fb.back[(std::size_t)y * fb.width];
+        FrameCell *f = &fb.front[(std::size_t)y * fb.width];
+        for (int x = 0; x < fb.width; x++)
+        {
+            if (b[x] == f[x])
+                continue;
+            if (x != curX || y != curY)
+            {
+                // A short gap of unchanged cells in the current colour is cheaper to
+                // rewrite than to jump over
+                bool rewrite = (y == curY && x - curX <= 4);
+                for (int g = curX; rewrite && g < x; g++)
+                    rewrite = (f[g].color == color);
+                if (rewrite)
+                {
+                    for (int g = curX; g < x; g++)
+                        out += f[g].ch;
+                }
+                else
+                {
+                    out += "\033[";
+                    frame_AppendInt(out, fb.originY + y + 1);
+                    out += ';';
+                    frame_AppendInt(out, fb.originX + x + 1);
+                    out += 'H';
+                }
+            }
+            if (b[x].color != color)
+            {
+                out += "\033[";
+                frame_AppendInt(out, b[x].color);
+                out += 'm';
+                color = b[x].color;
+            }
+            out += b[x].ch;
+            f[x] = b[x];
+            curX = x + 1;
+            curY = y;
+            cells++;
+        }
+    }
+    if (color > 0)
+        out += "\033[0m";
+    fb.valid = true;
+    return cells;
+}
+
+// Writes the changes of the composed frame to the screen in one write and records its timing
+inline void frame_Flush(FrameBuffer &fb, std::ostream &screen)
+{
+    using namespace std::chrono;
+    auto composed = steady_clock::now();
+    int cells = frame_Diff(fb);
+    if (!fb.out.empty())
+    {
+        screen.write(fb.out.data(), (std::streamsize)fb.out.size());
+        screen.flush();
+    }
+    auto done = steady_clock::now();
+
+    FrameStats &s = fb.stats;
+    s.composeMs = duration<double, std::milli>(composed - fb.started).count();
+    s.flushMs = duration<double, std::milli>(done - composed).count();
+    s.frameMs = s.composeMs + s.flushMs;
+    s.totalMs += s.frameMs;
+    s.maxMs = std::max(s.maxMs, s.frameMs);
+    s.frames++;
+    s.cells = cells;
+    s.bytes = fb.out.size();
+}
+
+#endif
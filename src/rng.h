@@ -0,0 +1,144 @@
+/**
+ * @file rng.h
+ * @brief Seedable random number streams (xoshiro256**) for the simulations.
+ *
+ * @details
+ * An Rng is a plain value holding 256 bits of state, so every simulation owns its stream
+ * and threads never share one. A stream is filled from a 64-bit seed through splitmix64, the
+ * expansion the xoshiro authors recommend, so the same seed always gives the same numbers on
+ * every platform and compiler.
+ *
+ * rng_Jump advances a stream by 2^128 draws. Starting from one seed, stream k is the seed's
+ * stream jumped k times; the streams cannot overlap in any run that could finish, which is
+ * how the per-thread and per-block streams of a parallel simulation are made (rng_Streams).
+ *
+ * rng_Below draws an unbiased integer in [0, n) by multiply and reject (Lemire), without the
+ * modulo bias of rand() % n.
+ */
+
+#ifndef NMS_RNG_H
+#define NMS_RNG_H
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct Rng
+{
+    std::uint64_t s[4] = {0, 0, 0, 0};
+};
+
+// Next value of the splitmix64 sequence, used to fill the state from a seed
+inline std::uint64_t rng_SplitMix(std::uint64_t &x)
+{
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline void rng_Seed(Rng &r, std::uint64_t seed)
+{
+    for (std::uint64_t &w : r.s)
+        w = rng_SplitMix(seed);
+}
+
+inline Rng rng_Make(std::uint64_t seed)
+{
+    Rng r;
+    rng_Seed(r, seed);
+    return r;
+}
+
+inline std::uint64_t rng_Rotl(std::uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256**
+inline std::uint64_t rng_Next(Rng &r)
+{
+    std::uint64_t *s = r.s;
+    std::uint64_t out = rng_Rotl(s[1] * 5, 7) * 9;
+    std::uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_Rotl(s[3], 45);
+    return out;
+}
+
+// Advances the stream by 2^128 draws
+inline void rng_Jump(Rng &r)
+{
+    static const std::uint64_t poly[4] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+    std::uint64_t t[4] = {0, 0, 0, 0};
+    for (std::uint64_t word : poly)
+        for (int b = 0; b < 64; b++)
+        {
+            if (word & (1ull << b))
+                for (int k = 0; k < 4; k++)
+                    t[k] ^= r.s[k];
+            rng_Next(r);
+        }
+    for (int k = 0; k < 4; k++)
+        r.s[k] = t[k];
+}
+
+// n streams from one seed, stream k jumped k times
+inline std::vector<Rng> rng_Streams(std::uint64_t seed, int n)
+{
+    std::vector<Rng> streams(n > 0 ? n : 0);
+    Rng r = rng_Make(seed);
+    for (Rng &s : streams)
+    {
+        s = r;
+        rng_Jump(r);
+    }
+    return streams;
+}
+
+// Uniform in [0, n), n > 0
+inline std::uint32_t rng_Below(Rng &r, std::uint32_t n)
+{
+    std::uint64_t m = (rng_Next(r) >> 32) * n;
+    if ((std::uint32_t)m < n)
+    {
+        std::uint32_t floor = (0u - n) % n;
+        while ((std::uint32_t)m < floor)
+            m = (rng_Next(r) >> 32) * n;
+    }
+    return (std::uint32_t)(m >> 32);
+}
+
+// Threshold of rng_Hit for probability p: a draw hits when its top 53 bits fall under it
+inline std::uint64_t rng_Limit(double p)
+{
+    p = p < 0 ? 0 : p > 1 ? 1 : p;
+    return (std::uint64_t)(p * 9007199254740992.0);
+}
+
+inline bool rng_Hit(Rng &r, std::uint64_t limit)
+{
+    return (rng_Next(r) >> 11) < limit;
+}
+
+// True with probability p
+inline bool rng_Chance(Rng &r, double p)
+{
+    return rng_Hit(r, rng_Limit(p));
+}
+
+// A fresh seed from the OS entropy source and the clock, for runs not given one
+inline std::uint64_t rng_NewSeed()
+{
+    std::random_device dev;
+    std::uint64_t seed = ((std::uint64_t)dev() << 32) ^ dev();
+    seed ^= (std::uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    return seed;
+}
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file rollup.h
+ * @brief Vectorized totals over the numeric table columns, overall and per dictionary code.
+ *
+ * @details
+ * The kernels run over the column chunks directly (see table.h), four doubles per AVX2
+ * instruction, and fall back to scalar code on CPUs without AVX2 or other architectures.
+ * The AVX2 path is compiled with a target attribute and chosen at run time, so the program
+ * is still built with the plain compile line.
+ *
+ * Both paths keep the same eight running sums and add them up in the same order, and no
+ * fused multiply-add is used, so a total comes out bit for bit the same whichever path
+ * computed it. Per-group totals multiply in the vector unit and add the products to one of
+ * four partial tables per group in row order, the scalar path likewise.
+ *
+ * Removed rows need no mask: table_Kill resets them to 0 and dictionary code 0, so they add
+ * nothing to a total and land in group 0.
+ */
+
+#ifndef NMS_ROLLUP_H
+#define NMS_ROLLUP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "table.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ROLLUP_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ROLLUP_AVX2
+#else
+#define ROLLUP_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+const int ROLLUP_LANES = 8; // Running sums of a total
+const int ROLLUP_SPLIT = 4; // Partial tables of a per-group total
+
+// Totals of one dictionary code
+struct RollupGroup
+{
+    long long rows = 0;
+    double sum = 0;
+};
+
+// True when the CPU and the OS support AVX2
+inline bool rollup_HasAvx2()
+{
+    static const bool has = []()
+    {
+#if defined(ROLLUP_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(ROLLUP_X86)
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        return false;
+#endif
+    }();
+    return has;
+}
+
+// Adds a[i] * b[i] (or a[i] when b is null) into the eight lane sums, lane i % 8
+inline void rollup_DotScalar(const double *a, const double *b, int n, double *lanes)
+{
+    for (int i = 0; i < n; i++)
+        lanes[i % ROLLUP_LANES] += b ? a[i] * b[i] : a[i];
+}
+
+// Multiplies a[i] * b[i] into out
+inline void rollup_MulScalar(const double *a, const double *b, int n, double *out)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = a[i] * b[i];
+}
+
+#ifdef ROLLUP_X86
+ROLLUP_AVX2 inline void rollup_DotAvx2(const double *a, const double *b, int n, double *lanes)
+{
+    __m256d lo = _mm256_loadu_pd(lanes), hi = _mm256_loadu_pd(lanes + 4);
+    int i = 0;
+    if (b)
+        for (; i + ROLLUP_LANES <= n; i += ROLLUP_LANES)
+        {
+            lo = _mm256_add_pd(lo, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            hi = _mm256_add_pd(hi, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+        }
+    else
+        for (; i + ROLLUP_LANES <= n; i += ROLLUP_LANES)
+        {
+            lo = _mm256_add_pd(lo, _mm256_loadu_pd(a + i));
+            hi = _mm256_add_pd(hi, _mm256_loadu_pd(a + i + 4));
+        }
+    _mm256_storeu_pd(lanes, lo);
+    _mm256_storeu_pd(lanes + 4, hi);
+    rollup_DotScalar(a + i, b ? b + i : nullptr, n - i, lanes);
+}
+
+ROLLUP_AVX2 inline void rollup_MulAvx2(const double *a, const double *b, int n, double *out)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    rollup_MulScalar(a + i, b + i, n - i, out + i);
+}
+#endif
+
+// Rows in chunk k of a column of count rows
+inline int rollup_ChunkRows(int count, size_t k)
+{
+    return std::min(TABLE_CHUNK_ROWS, count - (int)(k * TABLE_CHUNK_ROWS));
+}
+
+// Sum of a[i] * b[i], or of a[i] when b is null, over all rows
+inline double rollup_Dot(const Column<double> &a, const Column<double> *b, bool simd = rollup_HasAvx2())
+{
+    double lanes[ROLLUP_LANES] = {0};
+    for (size_t k = 0; k * TABLE_CHUNK_ROWS < (size_t)a.size(); k++)
+    {
+        const double *pa = a.chunks[k].get(), *pb = b ? b->chunks[k].get() : nullptr;
+        int n = rollup_ChunkRows(a.size(), k);
+#ifdef ROLLUP_X86
+        if (simd)
+        {
+            rollup_DotAvx2(pa, pb, n, lanes);
+            continue;
+        }
+#endif
+        rollup_DotScalar(pa, pb, n, lanes);
+    }
+    (void)simd;
+    return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+}
+
+inline double rollup_Sum(const Column<double> &a, bool simd = rollup_HasAvx2())
+{
+    return rollup_Dot(a, nullptr, simd);
+}
+
+// Rows and the sum of a[i] * b[i] (or a[i]) per dictionary code of g, indexed by code
+inline std::vector<RollupGroup> rollup_GroupDot(const Column<DictString> &g, const Column<double> &a, const Column<double> *b, bool simd = rollup_HasAvx2())
+{
+    // Rows go to ROLLUP_SPLIT tables in turn, so runs of one code do not wait on each other
+    size_t codes = g.dict.values.size();
+    std::vector<RollupGroup> split(codes * ROLLUP_SPLIT);
+    std::vector<double> products(b ? TABLE_CHUNK_ROWS : 0);
+    for (size_t k = 0; k * TABLE_CHUNK_ROWS < (size_t)a.size(); k++)
+    {
+        const DictCode *c = g.codes.chunks[k].get();
+        const double *v = a.chunks[k].get();
+        int n = rollup_ChunkRows(a.size(), k);
+        if (b)
+        {
+#ifdef ROLLUP_X86
+            if (simd)
+                rollup_MulAvx2(v, b->chunks[k].get(), n, products.data());
+            else
+#endif
+                rollup_MulScalar(v, b->chunks[k].get(), n, products.data());
+            v = products.data();
+        }
+        for (int i = 0; i < n; i++)
+        {
+            RollupGroup &x = split[c[i] * ROLLUP_SPLIT + (i % ROLLUP_SPLIT)];
+            x.rows++;
+            x.sum += v[i];
+        }
+    }
+    (void)simd;
+    std::vector<RollupGroup> groups(codes);
+    for (size_t code = 0; code < codes; code++)
+    {
+        const RollupGroup *x = &split[code * ROLLUP_SPLIT];
+        groups[code].rows = x[0].rows + x[1].rows + x[2].rows + x[3].rows;
+        groups[code].sum = (x[0].sum + x[1].sum) + (x[2].sum + x[3].sum);
+    }
+    return groups;
+}
+
+#endif
@@ -0,0 +1,403 @@
+/**
+ * @file snapshot.h
+ * @brief Versioned binary snapshot of every NMS table, loaded through a memory mapping.
+ *
+ * @details
+ * The CSV files stay the durable import/export format. The snapshot is a checkpoint of
+ * all tables taken at exit (or after a CSV boot) that lets the next start skip parsing:
+ * the file is mapped, validated and the columns are read straight out of the mapping.
+ *
+ * LAYOUT (little-endian, every section 8-byte aligned):
+ * - SnapHeader                     magic, version, sizes and checksum of everything after it
+ * - SnapTableDesc[tableCount]      name, row count, journal stamp, first column
+ * - SnapColumnDesc[...]            type and offset of each column
+ * - column data                    f64: rows x 8 bytes, bool: rows x 1 byte,
+ *                                  string: rows x (uint32 offset, uint32 length) into the heap
+ * - string heap                    raw bytes, not terminated
+ *
+ * Each table records the stamp of its CSV/delta files when the snapshot was taken. If
+ * the stamp no longer matches, the files changed after the snapshot and the table must
+ * be loaded from CSV instead.
+ */
+
+#ifndef NMS_SNAPSHOT_H
+#define NMS_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+const uint32_t SNAP_VERSION = 1;
+const char SNAP_MAGIC[8] = {'N', 'M', 'S', 'S', 'N', 'A', 'P', 0};
+
+enum SnapType : uint32_t
+{
+    SNAP_F64 = 1,
+    SNAP_BOOL = 2,
+    SNAP_STR = 3
+};
+
+struct SnapHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t tableCount;
+    uint64_t fileSize;
+    uint64_t heapOffset;
+    uint64_t heapSize;
+    uint64_t checksum;
+};
+
+struct SnapTableDesc
+{
+    char name[16];
+    uint64_t rows;
+    uint64_t stamp;
+    uint32_t columnCount;
+    uint32_t firstColumn;
+};
+
+struct SnapColumnDesc
+{
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+};
+
+struct SnapStr
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Word-wise multiplicative hash, fast enough to validate a large mapping on every start
+inline uint64_t snap_Checksum(const char *data, size_t size)
+{
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = (h ^ w) * 0x100000001B3ull;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++)
+        h = (h ^ (unsigned char)data[i]) * 0x100000001B3ull;
+    return h;
+}
+
+// ---------------------------------------------------------------- Writing
+
+struct SnapshotWriter
+{
+    struct Column
+    {
+        uint32_t type;
+        std::string data;
+    };
+    struct Table
+    {
+        std::string name;
+        uint64_t rows;
+        uint64_t stamp;
+        std::vector<Column> columns;
+    };
+    std::vector<Table> tables;
+    std::string heap;
+};
+
+// Starts a new table, the columns added next belong to it
+inline void snap_Table(SnapshotWriter &w, const std::string &name, uint64_t rows, uint64_t stamp)
+{
+    w.tables.push_back({name, rows, stamp, {}});
+}
+
+// The column writers take anything indexable by row: arrays or table columns
+template <class Col>
+void snap_Doubles(SnapshotWriter &w, const Col &v)
+{
+    SnapshotWriter::Table &t = w.tables.back();
+    std::string data(t.rows * sizeof(double), '\0');
+    for (uint64_t i = 0; i < t.rows; i++)
+    {
+        double d = v[i];
+        std::memcpy(&data[i * sizeof(double)], &d, sizeof(double));
+    }
+    t.columns.push_back({SNAP_F64, data});
+}
+
+template <class Col>
+void snap_Bools(SnapshotWriter &w, const Col &v)
+{
+    SnapshotWriter::Table &t = w.tables.back();
+    std::string data(t.rows, '\0');
+    for (uint64_t i = 0; i < t.rows; i++)
+        data[i] = v[i] ? 1 : 0;
+    t.columns.push_back({SNAP_BOOL, data});
+}
+
+template <class Col>
+void snap_Strings(SnapshotWriter &w, const Col &v)
+{
+    SnapshotWriter::Table &t = w.tables.back();
+    std::string data(t.rows * sizeof(SnapStr), '\0');
+    SnapStr *out = (SnapStr *)&data[0];
+    for (uint64_t i = 0; i < t.rows; i++)
+    {
+        std::string_view s = v[i];
+        out[i].offset = (uint32_t)w.heap.size();
+        out[i].length = (uint32_t)s.size();
+        w.heap += s;
+    }
+    t.columns.push_back({SNAP_STR, data});
+}
+
+inline size_t snap_Align(size_t n)
+{
+    return (n + 7) & ~(size_t)7;
+}
+
+// Lays the tables out and writes them to path through a temporary file
+inline bool snap_Write(const SnapshotWriter &w, const std::string &path)
+{
+    if (w.heap.size() > 0xFFFFFFFFull)
+        return false;
+
+    size_t columnCount = 0;
+    for (const SnapshotWriter::Table &t : w.tables)
+        columnCount += t.columns.size();
+
+    size_t at = sizeof(SnapHeader) + w.tables.size() * sizeof(SnapTableDesc) + columnCount * sizeof(SnapColumnDesc);
+    std::vector<SnapTableDesc> tables(w.tables.size());
+    std::vector<SnapColumnDesc> columns;
+    for (size_t i = 0; i < w.tables.size(); i++)
+    {
+        const SnapshotWriter::Table &t = w.tables[i];
+        memset(&tables[i], 0, sizeof(SnapTableDesc));
+        strncpy(tables[i].name, t.name.c_str(), sizeof(tables[i].name) - 1);
+        tables[i].rows = t.rows;
+        tables[i].stamp = t.stamp;
+        tables[i].columnCount = (uint32_t)t.columns.size();
+        tables[i].firstColumn = (uint32_t)columns.size();
+        for (const SnapshotWriter::Column &c : t.columns)
+        {
+            columns.push_back({c.type, 0, (uint64_t)at});
+            at = snap_Align(at + c.data.size());
+        }
+    }
+
+    SnapHeader h;
+    memcpy(h.magic, SNAP_MAGIC, sizeof(h.magic));
+    h.version = SNAP_VERSION;
+    h.tableCount = (uint32_t)w.tables.size();
+    h.heapOffset = at;
+    h.heapSize = w.heap.size();
+    h.fileSize = at + w.heap.size();
+
+    // body holds everything after the header, file offset x lands at body[x - sizeof(SnapHeader)]
+    std::string body(h.fileSize - sizeof(SnapHeader), '\0');
+    char *p = &body[0];
+    memcpy(p, tables.data(), tables.size() * sizeof(SnapTableDesc));
+    memcpy(p + tables.size() * sizeof(SnapTableDesc), columns.data(), columns.size() * sizeof(SnapColumnDesc));
+    size_t c = 0;
+    for (const SnapshotWriter::Table &t : w.tables)
+        for (const SnapshotWriter::Column &col : t.columns)
+            memcpy(p + columns[c++].offset - sizeof(SnapHeader), col.data.data(), col.data.size());
+    memcpy(p + h.heapOffset - sizeof(SnapHeader), w.heap.data(), w.heap.size());
+    h.checksum = snap_Checksum(body.data(), body.size());
+
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write((const char *)&h, sizeof(h));
+        out.write(body.data(), body.size());
+        if (!out)
+            return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+// ---------------------------------------------------------------- Reading
+
+struct SnapshotFile
+{
+    const char *data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#endif
+};
+
+struct SnapTable
+{
+    const SnapTableDesc *desc = nullptr;
+    const SnapColumnDesc *columns = nullptr;
+    uint64_t rows = 0;
+};
+
+inline void snap_Close(SnapshotFile &f)
+{
+#ifdef _WIN32
+    if (f.data)
+        UnmapViewOfFile(f.data);
+    if (f.mapping)
+        CloseHandle(f.mapping);
+    if (f.file != INVALID_HANDLE_VALUE)
+        CloseHandle(f.file);
+    f.mapping = NULL;
+    f.file = INVALID_HANDLE_VALUE;
+#else
+    if (f.data)
+        munmap((void *)f.data, f.size);
+#endif
+    f.data = nullptr;
+    f.size = 0;
+}
+
+// Checks that every descriptor stays inside the mapping before anything is read through it
+inline bool snap_Validate(const SnapshotFile &f)
+{
+    if (f.size < sizeof(SnapHeader))
+        return false;
+    const SnapHeader *h = (const SnapHeader *)f.data;
+    if (memcmp(h->magic, SNAP_MAGIC, sizeof(h->magic)) != 0 || h->version != SNAP_VERSION || h->fileSize != f.size)
+        return false;
+    if (h->heapOffset > f.size || h->heapSize > f.size - h->heapOffset)
+        return false;
+    uint64_t descEnd = sizeof(SnapHeader) + (uint64_t)h->tableCount * sizeof(SnapTableDesc);
+    if (descEnd > f.size)
+        return false;
+
+    const SnapTableDesc *tables = (const SnapTableDesc *)(f.data + sizeof(SnapHeader));
+    const SnapColumnDesc *columns = (const SnapColumnDesc *)(f.data + descEnd);
+    uint64_t columnCount = 0;
+    for (uint32_t i = 0; i < h->tableCount; i++)
+        columnCount += tables[i].columnCount;
+    if (descEnd + columnCount * sizeof(SnapColumnDesc) > f.size)
+        return false;
+    for (uint32_t i = 0; i < h->tableCount; i++)
+    {
+        if ((uint64_t)tables[i].firstColumn + tables[i].columnCount > columnCount)
+            return false;
+        for (uint32_t c = 0; c < tables[i].columnCount; c++)
+        {
+            const SnapColumnDesc &col = columns[tables[i].firstColumn + c];
+            uint64_t width = col.type == SNAP_F64 ? 8 : (col.type == SNAP_BOOL ? 1 : sizeof(SnapStr));
+            if (col.offset > h->heapOffset || tables[i].rows > (h->heapOffset - col.offset) / width)
+                return false;
+        }
+    }
+    return snap_Checksum(f.data + sizeof(SnapHeader), f.size - sizeof(SnapHeader)) == h->checksum;
+}
+
+// Maps the snapshot read-only and validates it, returns false if it is missing or damaged
+inline bool snap_Open(SnapshotFile &f, const std::string &path)
+{
+    snap_Close(f);
+#ifdef _WIN32
+    f.file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f.file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f.file, &size) || size.QuadPart == 0)
+    {
+        snap_Close(f);
+        return false;
+    }
+    f.mapping = CreateFileMappingA(f.file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!f.mapping)
+    {
+        snap_Close(f);
+        return false;
+    }
+    f.data = (const char *)MapViewOfFile(f.mapping, FILE_MAP_READ, 0, 0, 0);
+    f.size = (size_t)size.QuadPart;
+#else
+    // The mapping stays valid after the file is closed
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    struct stat st;
+    void *p = MAP_FAILED;
+    if (fstat(fileno(file), &st) == 0 && st.st_size > 0)
+        p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    fclose(file);
+    if (p == MAP_FAILED)
+        return false;
+    f.data = (const char *)p;
+    f.size = (size_t)st.st_size;
+#endif
+    if (!f.data || !snap_Validate(f))
+    {
+        snap_Close(f);
+        return false;
+    }
+    return true;
+}
+
+// Finds a table by name
+inline bool snap_Find(const SnapshotFile &f, const std::string &name, SnapTable &t)
+{
+    const SnapHeader *h = (const SnapHeader *)f.data;
+    const SnapTableDesc *tables = (const SnapTableDesc *)(f.data + sizeof(SnapHeader));
+    const SnapColumnDesc *columns = (const SnapColumnDesc *)(f.data + sizeof(SnapHeader) + h->tableCount * sizeof(SnapTableDesc));
+    for (uint32_t i = 0; i < h->tableCount; i++)
+    {
+        if (name == tables[i].name)
+        {
+            t.desc = &tables[i];
+            t.columns = columns + tables[i].firstColumn;
+            t.rows = tables[i].rows;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline const double *snap_DoubleColumn(const SnapshotFile &f, const SnapTable &t, uint32_t c)
+{
+    if (c >= t.desc->columnCount || t.columns[c].type != SNAP_F64)
+        return nullptr;
+    return (const double *)(f.data + t.columns[c].offset);
+}
+
+inline const uint8_t *snap_BoolColumn(const SnapshotFile &f, const SnapTable &t, uint32_t c)
+{
+    if (c >= t.desc->columnCount || t.columns[c].type != SNAP_BOOL)
+        return nullptr;
+    return (const uint8_t *)(f.data + t.columns[c].offset);
+}
+
+inline const SnapStr *snap_StringColumn(const SnapshotFile &f, const SnapTable &t, uint32_t c)
+{
+    if (c >= t.desc->columnCount || t.columns[c].type != SNAP_STR)
+        return nullptr;
+    return (const SnapStr *)(f.data + t.columns[c].offset);
+}
+
+// String of a string column, pointing into the mapping (no copy)
+inline std::string_view snap_String(const SnapshotFile &f, const SnapStr &s)
+{
+    const SnapHeader *h = (const SnapHeader *)f.data;
+    if ((uint64_t)s.offset + s.length > h->heapSize)
+        return std::string_view();
+    return std::string_view(f.data + h->heapOffset + s.offset, s.length);
+}
+
+#endif
@@ -0,0 +1,438 @@
+/**
+ * @file table.h
+ * @brief Typed column store used for the NMS datasets.
+ *
+ * @details
+ * A table is declared from a list of column descriptors. Each descriptor is a tag type
+ * carrying the element type and a display name:
+ *
+ *   TABLE_COLUMN(MissionName, std::string, "name");
+ *   TABLE_COLUMN(MissionCost, double, "cost");
+ *   using MissionTable = Table<MissionName, MissionCost>;
+ *
+ * Every column is stored on its own (structure of arrays), so a scan over one field never
+ * pulls in the others. Columns are looked up by tag at compile time; asking a table for a
+ * column it does not have fails to compile.
+ *
+ * Columns grow in chunks of TABLE_CHUNK_ROWS rows, so memory follows the row count and a
+ * row never moves when the table grows. String columns store their characters in a
+ * StringArena and hand out ArenaString references, which behave like a std::string for
+ * reading, comparing, concatenating and assigning.
+ *
+ * Fields with only a handful of distinct values (roles, statuses, categories) are declared
+ * with the DictString type instead. Such a column stores one DictCode per row and the
+ * distinct strings once, in a dictionary. Reads and writes look the same as for a string
+ * column, and filters can compare codes instead of strings (see dict_Code, dict_Rows).
+ *
+ * Rows are added and removed only through table_Append/table_Kill/table_Resize, which
+ * apply the change to every column, so the columns cannot drift out of step.
+ *
+ * Removing a row leaves a tombstone in its place: the row is cleared and flagged dead, and
+ * no other row moves, so deleting is O(columns) and row numbers stay put. The screens and
+ * batch mode show row + 1 as a record's ID, so a live row is never moved. Appends reuse
+ * dead rows first, and table_Compact trims dead rows off the end.
+ */
+
+#ifndef NMS_TABLE_H
+#define NMS_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Declares a column descriptor
+#define TABLE_COLUMN(Tag, Type, Label)                   \
+    struct Tag                                           \
+    {                                                    \
+        using type = Type;                               \
+        static constexpr const char *name = Label;       \
+    }
+
+const int TABLE_CHUNK_SHIFT = 12;
+const int TABLE_CHUNK_ROWS = 1 << TABLE_CHUNK_SHIFT;
+const size_t ARENA_BLOCK_BYTES = 64 * 1024;
+
+// Storage for one column in fixed-size chunks. Growing adds chunks and never moves the
+// rows already stored, and an empty column owns no memory at all.
+template <class T>
+struct Column
+{
+    std::vector<std::unique_ptr<T[]>> chunks;
+    int count = 0;
+
+    T &operator[](int i) { return chunks[i >> TABLE_CHUNK_SHIFT][i & (TABLE_CHUNK_ROWS - 1)]; }
+    const T &operator[](int i) const { return chunks[i >> TABLE_CHUNK_SHIFT][i & (TABLE_CHUNK_ROWS - 1)]; }
+    int size() const { return count; }
+
+    void resize(int n)
+    {
+        for (int i = n; i < count; i++)
+            (*this)[i] = T();
+        size_t need = ((size_t)n + TABLE_CHUNK_ROWS - 1) >> TABLE_CHUNK_SHIFT;
+        while (chunks.size() < need)
+            chunks.emplace_back(new T[TABLE_CHUNK_ROWS]());
+        chunks.resize(need);
+        count = n;
+    }
+    void reset(int i) { (*this)[i] = T(); }
+};
+
+// Append-only byte blocks holding the characters of a string column. Stored bytes never
+// move until the owning column compacts the arena.
+struct StringArena
+{
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t used = 0;     // Bytes used in the newest block
+    size_t capacity = 0; // Size of the newest block
+    size_t live = 0;     // Bytes referenced by the column
+    size_t garbage = 0;  // Bytes left behind by overwritten or removed values
+};
+
+// Copies s into the arena and returns a view of the copy
+inline std::string_view arena_Store(StringArena &a, std::string_view s)
+{
+    if (s.empty())
+        return std::string_view();
+    if (a.used + s.size() > a.capacity)
+    {
+        a.capacity = std::max(ARENA_BLOCK_BYTES, s.size());
+        a.blocks.emplace_back(new char[a.capacity]);
+        a.used = 0;
+    }
+    char *p = a.blocks.back().get() + a.used;
+    std::memcpy(p, s.data(), s.size());
+    a.used += s.size();
+    a.live += s.size();
+    return std::string_view(p, s.size());
+}
+
+// Reference to one cell of a string-valued column (Col is Column<std::string> or
+// Column<DictString>). Reads as a std::string_view, assigning stores the new value through
+// the column.
+template <class Col>
+struct StringRef
+{
+    Col *column;
+    int row;
+
+    std::string_view view() const { return std::as_const(*column)[row]; }
+    std::string str() const { return std::string(view()); }
+    operator std::string_view() const { return view(); }
+    operator std::string() const { return str(); }
+    bool empty() const { return view().empty(); }
+    size_t size() const { return view().size(); }
+
+    StringRef &operator=(std::string_view s)
+    {
+        column->set(row, s);
+        return *this;
+    }
+    StringRef &operator=(const std::string &s) { return *this = std::string_view(s); }
+    StringRef &operator=(const char *s) { return *this = std::string_view(s); }
+    StringRef &operator=(const StringRef &o) { return *this = o.view(); }
+    template <class Other>
+    StringRef &operator=(const StringRef<Other> &o) { return *this = o.view(); }
+
+    friend bool operator==(const StringRef &a, const StringRef &b) { return a.view() == b.view(); }
+    friend bool operator==(const StringRef &a, std::string_view b) { return a.view() == b; }
+    friend bool operator==(std::string_view a, const StringRef &b) { return a == b.view(); }
+    friend bool operator!=(const StringRef &a, const StringRef &b) { return a.view() != b.view(); }
+    friend bool operator!=(const StringRef &a, std::string_view b) { return a.view() != b; }
+    friend bool operator!=(std::string_view a, const StringRef &b) { return a != b.view(); }
+
+    friend std::string operator+(const StringRef &a, const StringRef &b) { return a.str().append(b.view()); }
+    friend std::string operator+(const StringRef &a, const std::string &b) { return a.str().append(b); }
+    friend std::string operator+(const StringRef &a, const char *b) { return a.str().append(b); }
+    friend std::string operator+(const std::string &a, const StringRef &b) { return std::string(a).append(b.view()); }
+    friend std::string operator+(const char *a, const StringRef &b) { return std::string(a).append(b.view()); }
+
+    friend std::ostream &operator<<(std::ostream &os, const StringRef &s) { return os << s.view(); }
+};
+
+template <>
+struct Column<std::string>;
+using ArenaString = StringRef<Column<std::string>>;
+
+// String columns keep a view per row and the characters in an arena, instead of one
+// heap allocation per value
+template <>
+struct Column<std::string>
+{
+    Column<std::string_view> views;
+    StringArena arena;
+
+    ArenaString operator[](int i) { return ArenaString{this, i}; }
+    std::string_view operator[](int i) const { return views[i]; }
+    int size() const { return views.size(); }
+
+    void set(int i, std::string_view s)
+    {
+        size_t old = views[i].size();
+        views[i] = arena_Store(arena, s);
+        arena.live -= old;
+        arena.garbage += old;
+        // Once most of the arena is dead, copy the live values into a fresh one
+        if (arena.garbage > ARENA_BLOCK_BYTES && arena.garbage > arena.live)
+        {
+            StringArena fresh;
+            for (int k = 0; k < views.size(); k++)
+                views[k] = arena_Store(fresh, views[k]);
+            arena = std::move(fresh);
+        }
+    }
+    void resize(int n)
+    {
+        for (int i = n; i < views.size(); i++)
+        {
+            arena.live -= views[i].size();
+            arena.garbage += views[i].size();
+        }
+        views.resize(n);
+        if (n == 0)
+            arena = StringArena();
+    }
+    void reset(int i) { set(i, std::string_view()); }
+};
+
+// Element type of a dictionary-encoded string column
+struct DictString
+{
+};
+using DictCode = std::uint32_t;
+
+// Distinct values of a dictionary column. Code 0 is always the empty string; codes are never
+// reused, so a code stays valid for the lifetime of the column.
+struct StringDict
+{
+    std::deque<std::string> values{std::string()}; // Indexed by code, a deque so lookup keys stay valid
+    std::unordered_map<std::string_view, DictCode> codes;
+};
+
+// Returns the code of s, adding it to the dictionary when it is new
+inline DictCode dict_Intern(StringDict &d, std::string_view s)
+{
+    if (s.empty())
+        return 0;
+    auto it = d.codes.find(s);
+    if (it != d.codes.end())
+        return it->second;
+    DictCode code = (DictCode)d.values.size();
+    d.values.emplace_back(s);
+    d.codes.emplace(d.values.back(), code);
+    return code;
+}
+
+template <>
+struct Column<DictString>
+{
+    Column<DictCode> codes;
+    StringDict dict;
+
+    StringRef<Column> operator[](int i) { return StringRef<Column>{this, i}; }
+    std::string_view operator[](int i) const { return dict.values[codes[i]]; }
+    int size() const { return codes.size(); }
+
+    void set(int i, std::string_view s) { codes[i] = dict_Intern(dict, s); }
+    void resize(int n) { codes.resize(n); }
+    void reset(int i) { codes[i] = 0; }
+};
+
+// Code of value in the column's dictionary, -1 when no row has ever held it
+inline long long dict_Code(const Column<DictString> &c, std::string_view value)
+{
+    if (value.empty())
+        return 0;
+    auto it = c.dict.codes.find(value);
+    return it == c.dict.codes.end() ? -1 : (long long)it->second;
+}
+
+// Rows holding value, in order. Scans the codes a chunk at a time without branching on
+// the data, so the compiler can keep the compare loop tight.
+inline std::vector<int> dict_Rows(const Column<DictString> &c, std::string_view value)
+{
+    std::vector<int> rows;
+    long long code = dict_Code(c, value);
+    if (code < 0)
+        return rows;
+    rows.resize(c.size());
+    int found = 0;
+    for (int base = 0; base < c.size(); base += TABLE_CHUNK_ROWS)
+    {
+        const DictCode *p = c.codes.chunks[base >> TABLE_CHUNK_SHIFT].get();
+        int n = std::min(TABLE_CHUNK_ROWS, c.size() - base);
+        for (int k = 0; k < n; k++)
+        {
+            rows[found] = base + k;
+            found += (p[k] == (DictCode)code);
+        }
+    }
+    rows.resize(found);
+    return rows;
+}
+
+// Number of rows holding value
+inline int dict_Count(const Column<DictString> &c, std::string_view value)
+{
+    long long code = dict_Code(c, value);
+    if (code < 0)
+        return 0;
+    int count = 0;
+    for (int base = 0; base < c.size(); base += TABLE_CHUNK_ROWS)
+    {
+        const DictCode *p = c.codes.chunks[base >> TABLE_CHUNK_SHIFT].get();
+        int n = std::min(TABLE_CHUNK_ROWS, c.size() - base);
+        for (int k = 0; k < n; k++)
+            count += (p[k] == (DictCode)code);
+    }
+    return count;
+}
+
+// Position of column C in Cols..., resolved by specialization
+template <class C, class... Cols>
+struct TableIndex;
+template <class C, class... Rest>
+struct TableIndex<C, C, Rest...>
+{
+    static constexpr std::size_t value = 0;
+};
+template <class C, class First, class... Rest>
+struct TableIndex<C, First, Rest...>
+{
+    static constexpr std::size_t value = 1 + TableIndex<C, Rest...>::value;
+};
+
+// Typed view of one row, valid until rows are added to or removed from the table
+template <class T>
+struct TableRow
+{
+    T *table;
+    int row;
+
+    template <class C>
+    decltype(auto) get() const { return table->template col<C>()[row]; }
+};
+
+template <class... Cols>
+struct Table
+{
+    std::tuple<Column<typename Cols::type>...> columns;
+    int rows = 0;
+    Column<bool> dead;          // Tombstone flag per row
+    int deadRows = 0;
+    std::vector<int> freeRows;  // Dead rows for table_Append to reuse, may hold stale entries
+
+    int size() const { return rows; }
+
+    template <class C>
+    Column<typename C::type> &col() { return std::get<TableIndex<C, Cols...>::value>(columns); }
+    template <class C>
+    const Column<typename C::type> &col() const { return std::get<TableIndex<C, Cols...>::value>(columns); }
+
+    TableRow<Table> operator[](int row) { return {this, row}; }
+};
+
+// Calls fn(column) for every column of the table
+template <class T, class Fn>
+void table_ForEach(T &t, Fn fn)
+{
+    std::apply([&](auto &...c)
+               { (fn(c), ...); },
+               t.columns);
+}
+
+// Sets the row count, new rows hold default values
+template <class T>
+void table_Resize(T &t, int n)
+{
+    for (int i = n; i < t.rows; i++)
+        t.deadRows -= t.dead[i];
+    table_ForEach(t, [&](auto &c)
+                  { c.resize(n); });
+    t.dead.resize(n);
+    t.rows = n;
+}
+
+template <class T>
+bool table_Live(const T &t, int row)
+{
+    return row >= 0 && row < t.rows && !t.dead[row];
+}
+
+// Adds a default row and returns its index, reusing a dead row when there is one
+template <class T>
+int table_Append(T &t)
+{
+    while (!t.freeRows.empty())
+    {
+        int r = t.freeRows.back();
+        t.freeRows.pop_back();
+        if (r < t.rows && t.dead[r])
+        {
+            t.dead[r] = false;
+            t.deadRows--;
+            return r;
+        }
+    }
+    table_Resize(t, t.rows + 1);
+    return t.rows - 1;
+}
+
+// Clears a row and leaves a tombstone in its place, no other row moves
+template <class T>
+void table_Kill(T &t, int row)
+{
+    if (!table_Live(t, row))
+        return;
+    table_ForEach(t, [&](auto &c)
+                  { c.reset(row); });
+    t.dead[row] = true;
+    t.deadRows++;
+    t.freeRows.push_back(row);
+    // Drop stale entries once they outnumber the real ones
+    if ((int)t.freeRows.size() > 2 * t.deadRows + 64)
+    {
+        std::vector<int> live;
+        for (int r : t.freeRows)
+            if (r < t.rows && t.dead[r])
+                live.push_back(r);
+        t.freeRows.swap(live);
+    }
+}
+
+// Rebuilds the tombstone count and free list after the dead flags were filled in directly
+template <class T>
+void table_Refresh(T &t)
+{
+    t.deadRows = 0;
+    t.freeRows.clear();
+    for (int r = t.rows - 1; r >= 0; r--)
+        if (t.dead[r])
+        {
+            t.deadRows++;
+            t.freeRows.push_back(r);
+        }
+}
+
+// Trims dead rows off the end of the table. Live rows never move, holes further up wait
+// on the free list for table_Append.
+template <class T>
+void table_Compact(T &t)
+{
+    int n = t.rows;
+    while (n > 0 && t.dead[n - 1])
+        n--;
+    if (n < t.rows)
+        table_Resize(t, n);
+}
+
+#endif
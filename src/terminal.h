@@ -0,0 +1,286 @@
+/**
+ * @file terminal.h
+ * @brief Console access for NMS behind one interface, with Win32 and POSIX backends.
+ *
+ * @details
+ * Everything the program needs from the console goes through the term_ functions:
+ * single-key reads, cursor positioning, clearing, the window title and sleeping. On
+ * Windows they map to conio and the console API; elsewhere the terminal is switched to
+ * non-canonical mode (termios) for the duration of a key read and the screen is driven
+ * with ANSI escape sequences. No function starts a child process.
+ *
+ * Keys come back as their character, or as one of the TERM_KEY_ codes for the arrow and
+ * paging keys, whichever backend read them. Line input (std::getline on std::cin) keeps
+ * the terminal's normal line editing, the terminal is only raw while a key is read.
+ *
+ * Key reads use the C stdio buffer of stdin on both backends, so they can be mixed freely
+ * with std::cin, which shares that buffer.
+ */
+
+#ifndef NMS_TERMINAL_H
+#define NMS_TERMINAL_H
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <conio.h>
+#else
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+// Codes returned by term_GetKey for keys that have no character
+const int TERM_KEY_UP = 0x101;
+const int TERM_KEY_DOWN = 0x102;
+const int TERM_KEY_LEFT = 0x103;
+const int TERM_KEY_RIGHT = 0x104;
+const int TERM_KEY_HOME = 0x105;
+const int TERM_KEY_END = 0x106;
+const int TERM_KEY_PGUP = 0x107;
+const int TERM_KEY_PGDN = 0x108;
+const int TERM_KEY_EOF = -1; // Input is closed
+
+#ifdef _WIN32
+
+// Turns on ANSI escape handling for the console
+inline void term_Init()
+{
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(out, &mode))
+        SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+}
+
+inline void term_Restore()
+{
+}
+
+// Waits for one key
+inline int term_GetKey()
+{
+    int c = _getch();
+    if (c != 0 && c != 224)
+        return c;
+    switch (_getch())
+    {
+    case 72:
+        return TERM_KEY_UP;
+    case 80:
+        return TERM_KEY_DOWN;
+    case 75:
+        return TERM_KEY_LEFT;
+    case 77:
+        return TERM_KEY_RIGHT;
+    case 71:
+        return TERM_KEY_HOME;
+    case 79:
+        return TERM_KEY_END;
+    case 73:
+        return TERM_KEY_PGUP;
+    case 81:
+        return TERM_KEY_PGDN;
+    }
+    return 0;
+}
+
+// True when term_GetKey would return without waiting
+inline bool term_KeyReady()
+{
+    return _kbhit() != 0;
+}
+
+// Drops keys typed ahead
+inline void term_FlushInput()
+{
+    FlushConsoleInputBuffer(GetStdHandle(STD_INPUT_HANDLE));
+}
+
+// Moves the cursor, 0-based
+inline void term_GotoXY(int x, int y)
+{
+    std::cout.flush();
+    COORD coordinates;
+    coordinates.X = (SHORT)x;
+    coordinates.Y = (SHORT)y;
+    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coordinates);
+}
+
+inline void term_SetTitle(const std::string &title)
+{
+    SetConsoleTitleA(title.c_str());
+}
+
+inline void term_Sleep(int ms)
+{
+    Sleep((DWORD)ms);
+}
+
+#else
+
+struct TermState
+{
+    bool saved = false;
+    termios cooked; // Settings found at start-up, restored after every key read
+};
+
+inline TermState &term_State()
+{
+    static TermState s;
+    return s;
+}
+
+// Puts stdin in non-canonical mode, with reads returning after min bytes or tenths/10 s
+inline void term_Raw(int min, int tenths)
+{
+    TermState &s = term_State();
+    if (!s.saved)
+        return;
+    termios raw = s.cooked;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = (cc_t)min;
+    raw.c_cc[VTIME] = (cc_t)tenths;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+}
+
+inline void term_Cooked()
+{
+    TermState &s = term_State();
+    if (s.saved)
+        tcsetattr(STDIN_FILENO, TCSANOW, &s.cooked);
+}
+
+// Restores the terminal as it was found and shows the cursor again
+inline void term_Restore()
+{
+    term_Cooked();
+    std::fputs("\033[0m\033[?25h", stdout);
+    std::fflush(stdout);
+}
+
+// Remembers the terminal settings so every key read can put them back
+inline void term_Init()
+{
+    TermState &s = term_State();
+    if (!s.saved && isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &s.cooked) == 0)
+    {
+        s.saved = true;
+        std::atexit(term_Restore);
+    }
+}
+
+// Reads one byte, waiting at most for the VTIME set by term_Raw, -1 when nothing came
+inline int term_ReadByte()
+{
+    int c = std::getchar();
+    if (c == EOF && term_State().saved)
+        std::clearerr(stdin);
+    return c;
+}
+
+// Waits for one key
+inline int term_GetKey()
+{
+    std::cout.flush();
+    term_Raw(1, 0);
+    int c = term_ReadByte();
+    if (c == 27)
+    {
+        // An escape sequence arrives in one burst, a lone Esc does not continue
+        term_Raw(0, 1);
+        int c1 = term_ReadByte();
+        if (c1 == '[' || c1 == 'O')
+        {
+            int c2 = term_ReadByte();
+            if (c2 >= '0' && c2 <= '9')
+            {
+                int c3 = term_ReadByte();
+                if (c3 == '~')
+                    c = (c2 == '5' ? TERM_KEY_PGUP : c2 == '6' ? TERM_KEY_PGDN : (c2 == '1' || c2 == '7') ? TERM_KEY_HOME : (c2 == '4' || c2 == '8') ? TERM_KEY_END : 0);
+                else
+                    c = 0;
+            }
+            else if (c2 == 'A')
+                c = TERM_KEY_UP;
+            else if (c2 == 'B')
+                c = TERM_KEY_DOWN;
+            else if (c2 == 'C')
+                c = TERM_KEY_RIGHT;
+            else if (c2 == 'D')
+                c = TERM_KEY_LEFT;
+            else if (c2 == 'H')
+                c = TERM_KEY_HOME;
+            else if (c2 == 'F')
+                c = TERM_KEY_END;
+            else
+                c = 0;
+        }
+        else if (c1 != EOF)
+            std::ungetc(c1, stdin);
+    }
+    else if (c == '\n')
+        c = '\r'; // What the Enter key gives under conio
+    term_Cooked();
+    return c == EOF ? TERM_KEY_EOF : c;
+}
+
+// True when term_GetKey would return without waiting
+inline bool term_KeyReady()
+{
+    if (!term_State().saved)
+    {
+        pollfd p = {STDIN_FILENO, POLLIN, 0};
+        return poll(&p, 1, 0) > 0;
+    }
+    // Looks through the stdio buffer as well as the terminal
+    term_Raw(0, 0);
+    int c = std::getchar();
+    if (c == EOF)
+        std::clearerr(stdin);
+    else
+        std::ungetc(c, stdin);
+    term_Cooked();
+    return c != EOF;
+}
+
+// Drops keys typed ahead
+inline void term_FlushInput()
+{
+    if (term_State().saved)
+        tcflush(STDIN_FILENO, TCIFLUSH);
+}
+
+// Moves the cursor, 0-based
+inline void term_GotoXY(int x, int y)
+{
+    std::cout << "\033[" << y + 1 << ';' << x + 1 << 'H';
+}
+
+inline void term_SetTitle(const std::string &title)
+{
+    std::cout << "\033]0;" << title << '\a';
+}
+
+inline void term_Sleep(int ms)
+{
+    std::cout.flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+#endif
+
+// Clears the screen and homes the cursor
+inline void term_Clear()
+{
+    std::cout << "\033[0m\033[2J\033[H" << std::flush;
+}
+
+#endif
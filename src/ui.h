@@ -0,0 +1,151 @@
+/**
+ * @file ui.h
+ * @brief Retained menu screens drawn through the diff renderer.
+ *
+ * @details
+ * A UiScreen is a list of widgets (text lines and boxes) that is built once and kept for
+ * the life of the program. The screen composes its widgets into a cached frame the first
+ * time it is shown and again only after a widget has changed, so showing a menu is a copy
+ * of the cached cells followed by a diff against what is already on the console.
+ *
+ * The menus share one UiConsole. Going from one menu to another writes only the cells in
+ * which they differ (the logo and most of the box stay put), and showing the screen that
+ * is already up with no widget changed writes nothing at all. Anything that draws to the
+ * console outside the UI must call ui_Invalidate so the next screen is drawn in full.
+ */
+
+#ifndef NMS_UI_H
+#define NMS_UI_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "render.h"
+
+enum UiKind : std::uint8_t
+{
+    UI_TEXT,
+    UI_BOX
+};
+
+struct UiWidget
+{
+    UiKind kind = UI_TEXT;
+    int x = 0, y = 0;
+    int width = 0, height = 0; // Boxes only
+    std::string text;
+    std::uint8_t color = FC_DEFAULT;
+};
+
+struct UiScreen
+{
+    std::vector<UiWidget> widgets;
+    std::vector<FrameCell> cache; // Composed frame, valid while dirty is false
+    bool dirty = true;
+};
+
+struct UiConsole
+{
+    FrameBuffer frame;
+    const UiScreen *shown = nullptr; // Screen the console shows, null when unknown
+};
+
+// Adds a line of text and returns its widget id
+inline int ui_Text(UiScreen &s, int x, int y, std::string_view text, std::uint8_t color = FC_DEFAULT)
+{
+    UiWidget w;
+    w.kind = UI_TEXT;
+    w.x = x;
+    w.y = y;
+    w.text = std::string(text);
+    w.color = color;
+    s.widgets.push_back(w);
+    s.dirty = true;
+    return (int)s.widgets.size() - 1;
+}
+
+// Adds a border in the style of drawBox and returns its widget id
+inline int ui_Box(UiScreen &s, int x, int y, int width, int height, std::uint8_t color = FC_DEFAULT)
+{
+    UiWidget w;
+    w.kind = UI_BOX;
+    w.x = x;
+    w.y = y;
+    w.width = width;
+    w.height = height;
+    w.color = color;
+    s.widgets.push_back(w);
+    s.dirty = true;
+    return (int)s.widgets.size() - 1;
+}
+
+// Changes the text and colour of a widget, the screen is recomposed only if they differ
+inline void ui_Set(UiScreen &s, int id, std::string_view text, std::uint8_t color)
+{
+    UiWidget &w = s.widgets[id];
+    if (w.text == text && w.color == color)
+        return;
+    w.text = std::string(text);
+    w.color = color;
+    s.dirty = true;
+}
+
+inline void ui_Set(UiScreen &s, int id, std::string_view text)
+{
+    ui_Set(s, id, text, s.widgets[id].color);
+}
+
+inline void ui_DrawWidget(FrameBuffer &fb, const UiWidget &w)
+{
+    if (w.kind == UI_TEXT)
+    {
+        frame_Text(fb, w.x, w.y, w.text, w.color);
+        return;
+    }
+    // Same shape as drawBox: double bars on the sides and a bottom edge one cell longer
+    frame_Put(fb, w.x, w.y, '+', w.color);
+    for (int i = 1; i < w.width - 1; i++)
+        frame_Put(fb, w.x + i, w.y, '=', w.color);
+    frame_Put(fb, w.x + w.width - 1, w.y, '+', w.color);
+    for (int i = 1; i < w.height - 1; i++)
+    {
+        frame_Text(fb, w.x, w.y + i, "||", w.color);
+        frame_Text(fb, w.x + w.width - 1, w.y + i, "||", w.color);
+    }
+    int bottom = w.y + w.height - 1;
+    frame_Put(fb, w.x, bottom, '+', w.color);
+    for (int i = 1; i < w.width; i++)
+        frame_Put(fb, w.x + i, bottom, '=', w.color);
+    frame_Put(fb, w.x + w.width, bottom, '+', w.color);
+}
+
+// Forgets what is on the console, e.g. after a screen was drawn without the UI
+inline void ui_Invalidate(UiConsole &con)
+{
+    frame_Invalidate(con.frame);
+    con.shown = nullptr;
+}
+
+// Brings the console to screen s, writing only the cells that differ from what it shows
+inline void ui_Show(UiConsole &con, UiScreen &s, std::ostream &screen)
+{
+    FrameBuffer &fb = con.frame;
+    if (con.shown == &s && !s.dirty && fb.valid)
+        return;
+    frame_Clear(fb);
+    if (s.dirty || s.cache.size() != fb.back.size())
+    {
+        for (const UiWidget &w : s.widgets)
+            ui_DrawWidget(fb, w);
+        s.cache = fb.back;
+        s.dirty = false;
+    }
+    else
+        fb.back = s.cache;
+    frame_Flush(fb, screen);
+    con.shown = &s;
+}
+
+#endif
@@ -0,0 +1,43 @@
+#!/bin/sh
+# Regression test: a malformed row dropped while loading must not shift the row numbers
+# later delta records and snapshot boots use.
+#
+#   g++ -std=c++17 -pthread src/nms.cpp -o nms && sh tests/journal_dropped_rows.sh ./nms
+#
+# The base inventory is Alpha, BROKEN, Charlie, Delta. An interactive boot drops BROKEN and
+# writes the snapshot, a batch boot from that snapshot deletes item 2 (Charlie), and a
+# boot from the CSV files alone must then list Alpha and Delta only. The dropped line must
+# be kept in nasa_inv.csv.rejects.
+
+NMS=$(cd "$(dirname "${1:-./nms}")" && pwd)/$(basename "${1:-./nms}")
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+
+printf '4\nAlpha,Tools,1,pc,1\nBROKEN\nCharlie,Tools,3,pc,3\nDelta,Tools,4,pc,4\n' > nasa_inv.csv
+printf 'signin themystery 29July1958\ninventory delete 2\n' > delete.txt
+printf 'signin themystery 29July1958\ninventory list\n' > list.txt
+
+# Interactive boot, stopped once the snapshot is written and before anything is saved
+"$NMS" < /dev/null > /dev/null 2>&1 &
+PID=$!
+for i in $(seq 100); do
+    [ -f nasa_snapshot.bin ] && break
+    sleep 0.1
+done
+sleep 0.5
+kill "$PID" 2> /dev/null
+wait "$PID" 2> /dev/null
+[ -f nasa_snapshot.bin ] || { echo "FAIL: no snapshot written"; exit 1; }
+
+"$NMS" --batch delete.txt > /dev/null 2>&1 || { echo "FAIL: delete"; exit 1; }
+sleep 0.5
+rm -f nasa_snapshot.bin
+
+GOT=$("$NMS" --batch list.txt 2> /dev/null | grep '^[0-9]*,' | cut -d, -f2 | tr '\n' ' ')
+if [ "$GOT" != "Alpha Delta " ]; then
+    echo "FAIL: expected 'Alpha Delta ', got '$GOT'"
+    exit 1
+fi
+grep -q ',BROKEN$' nasa_inv.csv.rejects 2> /dev/null || { echo "FAIL: dropped line not kept"; exit 1; }
+echo "PASS"